@@ -0,0 +1,131 @@
+/*************************************************************************************************
+CNFTools -- Copyright (c) 2021, Markus Iser, KIT - Karlsruhe Institute of Technology
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT
+OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ **************************************************************************************************/
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <algorithm>
+
+#include "lib/md5/md5.h"
+
+#include "src/util/StreamBuffer.h"
+#include "src/util/GBDHash.h"
+
+/**
+ * Throughput benchmark of the GBD hash on a generated random 3-CNF with comments: the buffered implementation
+ * (gbd_hash_from_dimacs) against the former one md5 call per clause, the parser alone, and the fast hash.
+ * Prints the best of several runs in MB/s of input and returns 1 if the hashes differ.
+ * Usage: hash_bench [number of clauses (default: 2000000)] [file (default: hash_bench.cnf)]
+ */
+
+static volatile uint64_t sink;
+
+template <typename Function>
+double best_of(unsigned runs, Function function) {
+    double best = 1e9;
+    for (unsigned r = 0; r < runs; r++) {
+        auto start = std::chrono::steady_clock::now();
+        function();
+        best = std::min(best, std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+    }
+    return best;
+}
+
+// GBD hash with one md5 call per clause (the implementation before NormalizedDimacsBuffer)
+static std::string gbd_hash_per_clause(const char* filename) {
+    md5::md5_t md5;
+    StreamBuffer in(filename);
+    std::string clause("");
+    while (!in.eof()) {
+        in.skipWhitespace();
+        if (in.eof()) {
+            break;
+        }
+        if (*in == 'p' || *in == 'c') {
+            in.skipLine();
+        } else {
+            for (int plit = in.readInteger(); plit != 0; plit = in.readInteger()) {
+                clause.append(std::to_string(plit));
+                clause.append(" ");
+            }
+            clause.append("0");
+            md5.process(clause.c_str(), clause.length());
+            clause.assign(" ");
+        }
+    }
+    return md5_string(md5);
+}
+
+// Parser without hashing (lower bound of the time per file)
+static void parse_only(const char* filename) {
+    StreamBuffer in(filename);
+    int64_t sum = 0;
+    while (!in.eof()) {
+        in.skipWhitespace();
+        if (in.eof()) {
+            break;
+        }
+        if (*in == 'p' || *in == 'c') {
+            in.skipLine();
+        } else {
+            for (int plit = in.readInteger(); plit != 0; plit = in.readInteger()) sum += plit;
+        }
+    }
+    sink = sum;
+}
+
+int main(int argc, char** argv) {
+    const size_t n = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 2000000;
+    const char* filename = argc > 2 ? argv[2] : "hash_bench.cnf";
+    const unsigned vars = std::max<size_t>(n / 4, 3), runs = 5;
+
+    FILE* file = std::fopen(filename, "w");
+    if (file == nullptr) {
+        std::printf("cannot write %s\n", filename);
+        return 1;
+    }
+    std::mt19937 rng(1);
+    std::fprintf(file, "c random 3-cnf\np cnf %u %zu\n", vars, n);
+    for (size_t c = 0; c < n; c++) {
+        if (c % 1000 == 0) std::fprintf(file, "c clause %zu\n", c);
+        for (unsigned k = 0; k < 3; k++) std::fprintf(file, "%s%u ", rng() & 1 ? "-" : "", 1 + rng() % vars);
+        std::fprintf(file, "0\n");
+    }
+    const double mb = std::ftell(file) / 1e6;
+    std::fclose(file);
+
+    std::string buffered, per_clause;
+    const double t_parse = best_of(runs, [&] () { parse_only(filename); });
+    const double t_per_clause = best_of(runs, [&] () { per_clause = gbd_hash_per_clause(filename); });
+    const double t_buffered = best_of(runs, [&] () { buffered = gbd_hash_from_dimacs(filename); });
+    const double t_fast = best_of(runs, [&] () { sink = fast_hash_from_dimacs(filename).size(); });
+
+    std::printf("%.1f MB, %zu clauses\n", mb, n);
+    std::printf("%-28s %10s %10s\n", "", "seconds", "MB/s");
+    std::printf("%-28s %10.3f %10.1f\n", "parser only", t_parse, mb / t_parse);
+    std::printf("%-28s %10.3f %10.1f\n", "gbd hash (md5 per clause)", t_per_clause, mb / t_per_clause);
+    std::printf("%-28s %10.3f %10.1f\n", "gbd hash (buffered)", t_buffered, mb / t_buffered);
+    std::printf("%-28s %10.3f %10.1f\n", "fast hash (buffered)", t_fast, mb / t_fast);
+    std::remove(filename);
+
+    if (buffered != per_clause) std::printf("hashes differ: %s %s\n", buffered.c_str(), per_clause.c_str());
+    return buffered == per_clause ? 0 : 1;
+}
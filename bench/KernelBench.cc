@@ -0,0 +1,192 @@
+/*************************************************************************************************
+CNFTools -- Copyright (c) 2021, Markus Iser, KIT - Karlsruhe Institute of Technology
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT
+OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ **************************************************************************************************/
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+#include <algorithm>
+
+#include "src/features/Kernels.h"
+
+/**
+ * Microbenchmark of the counting and reduction kernels against the scalar loops they replace
+ * (build with and without -mavx2 to compare both code paths). Prints the best of several runs in milliseconds
+ * and returns 1 if a kernel result differs from its scalar reference.
+ * Usage: kernel_bench [number of counters (default: 20000000)]
+ */
+
+static volatile uint64_t sink;
+
+template <typename Function>
+double best_of(unsigned runs, Function function) {
+    double best = 1e9;
+    for (unsigned r = 0; r < runs; r++) {
+        auto start = std::chrono::steady_clock::now();
+        function();
+        best = std::min(best, std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+    }
+    return best;
+}
+
+static void report(const char* name, double scalar, double kernel) {
+    std::printf("%-32s %10.2f %10.2f %8.2fx\n", name, scalar, kernel, scalar / kernel);
+}
+
+int main(int argc, char** argv) {
+    const size_t n = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 20000000;
+    const unsigned runs = 7;
+    std::mt19937 rng(1);
+    bool ok = true;
+
+#ifdef __AVX2__
+    std::printf("kernels: AVX2\n");
+#else
+    std::printf("kernels: scalar\n");
+#endif
+    std::printf("%-32s %10s %10s %9s\n", "", "scalar ms", "kernel ms", "speedup");
+
+    // per-clause sign count
+    std::vector<Cl> clauses(n / 10);
+    std::discrete_distribution<unsigned> clause_size({ 0, 0, 10, 30, 10, 5, 0, 0, 0, 0, 0, 0, 10 });
+    for (Cl& clause : clauses) {
+        for (unsigned k = clause_size(rng); k > 0; k--) clause.push_back(Lit(rng() % 1000000, rng() & 1));
+    }
+    uint64_t negative_scalar = 0, negative_kernel = 0;
+    double scalar = best_of(runs, [&] () {
+        uint64_t total = 0;
+        for (const Cl& clause : clauses) {
+            unsigned neg = 0;
+            for (Lit lit : clause) if (lit.sign()) ++neg;
+            total += neg;
+        }
+        sink = negative_scalar = total;
+    });
+    double kernel = best_of(runs, [&] () {
+        uint64_t total = 0;
+        for (const Cl& clause : clauses) total += count_negative(clause);
+        sink = negative_kernel = total;
+    });
+    report("sign count per clause", scalar, kernel);
+    ok &= negative_scalar == negative_kernel;
+
+    for (double p : { 0.2, 0.6, 0.95 }) {
+        std::vector<uint32_t> data(n);
+        std::geometric_distribution<uint32_t> geometric(p);
+        for (uint32_t& x : data) x = geometric(rng);
+        std::printf("counters, geometric p=%.2f\n", p);
+
+        MinMaxSum expected { data[0], data[0], 0 }, actual;
+        scalar = best_of(runs, [&] () {
+            uint32_t min = data[0], max = data[0];
+            uint64_t sum = 0;
+            for (size_t i = 0; i < n; i++) {
+                if (data[i] < min) min = data[i];
+                if (data[i] > max) max = data[i];
+                sum += data[i];
+            }
+            expected = MinMaxSum { min, max, sum };
+            sink = sum;
+        });
+        kernel = best_of(runs, [&] () {
+            actual = min_max_sum(data.data(), n);
+            sink = actual.sum;
+        });
+        report("  min/max/sum", scalar, kernel);
+        ok &= expected.min == actual.min && expected.max == actual.max && expected.sum == actual.sum;
+
+        const double mean = static_cast<double>(expected.sum) / n;
+        double deviation_scalar = 0, deviation_kernel = 0;
+        scalar = best_of(runs, [&] () {
+            double result = 0;
+            for (size_t i = 0; i < n; i++) {
+                double d = data[i] - mean;
+                result += d * d;
+            }
+            deviation_scalar = result;
+            sink = static_cast<uint64_t>(result);
+        });
+        kernel = best_of(runs, [&] () {
+            deviation_kernel = squared_deviation(data.data(), n, mean);
+            sink = static_cast<uint64_t>(deviation_kernel);
+        });
+        report("  squared deviation", scalar, kernel);
+        ok &= std::abs(deviation_scalar - deviation_kernel) <= 1e-9 * deviation_scalar;
+
+        std::vector<uint64_t> histogram_scalar, histogram_kernel;
+        scalar = best_of(runs, [&] () {
+            histogram_scalar.assign(size_t(expected.max) + 1, 0);
+            for (size_t i = 0; i < n; i++) ++histogram_scalar[data[i]];
+            sink = histogram_scalar[0];
+        });
+        kernel = best_of(runs, [&] () {
+            histogram_kernel.clear();
+            count_frequencies(data.data(), n, expected.max, &histogram_kernel);
+            sink = histogram_kernel[0];
+        });
+        report("  histogram", scalar, kernel);
+        ok &= histogram_scalar == histogram_kernel;
+    }
+
+    // intersection of sorted neighbourhoods (pairs of random subsets of [0, 4 * size))
+    for (size_t size : { 8, 64, 1024 }) {
+        const size_t pairs = std::max<size_t>(1, n / (4 * size));
+        std::vector<std::vector<uint32_t>> sets(2 * std::min<size_t>(pairs, 1024));
+        for (std::vector<uint32_t>& set : sets) {
+            for (uint32_t x = 0; x < 4 * size; x++) if (rng() % 4 == 0) set.push_back(x);
+        }
+        size_t common_scalar = 0, common_kernel = 0;
+        scalar = best_of(runs, [&] () {
+            size_t common = 0;
+            for (size_t p = 0; p < pairs; p++) {
+                const std::vector<uint32_t>& a = sets[(2 * p) % sets.size()];
+                const std::vector<uint32_t>& b = sets[(2 * p + 1) % sets.size()];
+                for (size_t i = 0, j = 0; i < a.size() && j < b.size(); ) {
+                    if (a[i] < b[j]) {
+                        ++i;
+                    } else if (b[j] < a[i]) {
+                        ++j;
+                    } else {
+                        ++common;
+                        ++i;
+                        ++j;
+                    }
+                }
+            }
+            sink = common_scalar = common;
+        });
+        kernel = best_of(runs, [&] () {
+            size_t common = 0;
+            for (size_t p = 0; p < pairs; p++) {
+                const std::vector<uint32_t>& a = sets[(2 * p) % sets.size()];
+                const std::vector<uint32_t>& b = sets[(2 * p + 1) % sets.size()];
+                common += intersect(a.data(), a.size(), b.data(), b.size(), [] (uint32_t) { });
+            }
+            sink = common_kernel = common;
+        });
+        char name[64];
+        std::snprintf(name, sizeof(name), "intersection, ~%zu values", size);
+        report(name, scalar, kernel);
+        ok &= common_scalar == common_kernel;
+    }
+
+    if (!ok) std::printf("kernel results differ from the scalar reference\n");
+    return ok ? 0 : 1;
+}
@@ -24,7 +24,8 @@ module = Extension("gbdc",
         libraries = ["archive", "cadical"],
         library_dirs=[os.path.abspath("./build/cadical/src/Cadical/build")],
         include_dirs=[".", "/opt/homebrew/Cellar/libarchive/3.5.2/include"],
-        sources = ["src/gbdlib.cc", "lib/md5/md5.cpp"])
+        sources = ["src/gbdlib.cc", "lib/md5/md5.cpp"],
+        extra_compile_args=["-mavx2"] if os.environ.get("CNFTOOLS_AVX2") == "1" else [])
 
 setup(name="gbdc", 
         version="2.0",
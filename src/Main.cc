@@ -21,11 +21,19 @@ OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWA
 #include <iterator>
 #include <algorithm>
 #include <array>
+#include <filesystem>
+#include <memory>
+#include <functional>
+#include <fstream>
 
 #include "lib/argparse/argparse.hpp"
 #include "lib/ipasir.h"
 
 #include "src/util/GBDHash.h"
+#include "src/util/HashBatch.h"
+#include "src/util/HashCache.h"
+#include "src/util/InvariantHash.h"
+#include "src/util/WLFingerprint.h"
 #include "src/util/CNFFormula.h"
 #include "src/util/SolverTypes.h"
 
@@ -34,25 +42,30 @@ OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWA
 
 #include "src/features/GateStats.h"
 #include "src/features/CNFStats.h"
+#include "src/features/ApproxCNFStats.h"
 
 
 int main(int argc, char** argv) {
     argparse::ArgumentParser argparse("CNF Tools");
 
-    argparse.add_argument("tool").help("Select Tool: solve, gbdhash, normalize, isp, extract, gates, aux")
+    argparse.add_argument("tool").help("Select Tool: solve, gbdhash, fasthash, permhash, wlhash, verify, normalize, isp, extract, gates, aux")
         .default_value("gbdhash")
         .action([](const std::string& value) {
-            static const std::vector<std::string> choices = { "solve", "gbdhash", "normalize", "isp", "extract", "gates", "aux"};
+            static const std::vector<std::string> choices = { "solve", "gbdhash", "fasthash", "permhash", "wlhash", "verify", "normalize", "isp", "extract", "gates", "aux"};
             if (std::find(choices.begin(), choices.end(), value) != choices.end()) {
                 return value;
             }
             return std::string{ "gbdhash" };
         });
 
-    argparse.add_argument("file").help("Give Path");
+    argparse.add_argument("file").help("Give Path (gbdhash, fasthash, permhash: also a directory, or - to read paths from stdin; verify: manifest with lines 'hash path', or - for stdin)");
+
+    argparse.add_argument("files").help("Further paths for batch mode of gbdhash, fasthash and permhash (give options before paths)")
+        .default_value(std::vector<std::string>())
+        .remaining();
 
     argparse.add_argument("-t", "--timeout")
-        .help("Timeout in seconds (default: 0, disabled)")
+        .help("Timeout in seconds of wallclock time (default: 0, disabled)")
         .default_value(0)
         .scan<'i', int>();
 
@@ -66,6 +79,39 @@ int main(int argc, char** argv) {
         .default_value(0)
         .scan<'i', int>();
 
+    argparse.add_argument("-j", "--threads")
+        .help("Number of worker threads (default: 1, 0 for all cores)")
+        .default_value(1)
+        .scan<'i', int>();
+
+    argparse.add_argument("-c", "--cache")
+        .help("Hash cache file for gbdhash, skips hashing of files with unchanged metadata (default: none)")
+        .default_value(std::string(""));
+
+    argparse.add_argument("--simd")
+        .help("gbdhash batch mode: use multi-buffer md5 engine (eight files per worker in parallel SIMD lanes)")
+        .default_value(false)
+        .implicit_value(true);
+
+    argparse.add_argument("--renaming")
+        .help("permhash: hash is also invariant under renaming of variables (requires to load the formula)")
+        .default_value(false)
+        .implicit_value(true);
+
+    argparse.add_argument("--features")
+        .help("extract: comma-separated list of feature groups (sizes, horn, vg, balance, vcg, cg, binary, powerlaw, clustering, community, spectral, treewidth, localsearch, cdcl, propagation, or all; default: sizes to binary)")
+        .default_value(std::string(""));
+
+    argparse.add_argument("--approximate")
+        .help("extract: approximate features in bounded memory from a single streaming pass (with error estimates)")
+        .default_value(false)
+        .implicit_value(true);
+
+    argparse.add_argument("--sample")
+        .help("extract --approximate: number of sampled variables and clauses (default: 65536)")
+        .default_value(65536)
+        .scan<'i', int>();
+
     argparse.add_argument("-r", "--repeat")
         .help("Give number of root selections for gate recognition")
         .default_value(1)
@@ -81,13 +127,64 @@ int main(int argc, char** argv) {
     }
 
     std::string filename = argparse.get("file");
+    std::vector<std::string> files = argparse.get<std::vector<std::string>>("files");
     std::string toolname = argparse.get("tool");
     int repeat = argparse.get<int>("repeat");
     ResourceLimits limits(argparse.get<int>("timeout"), argparse.get<int>("memout"));
     int verbose = argparse.get<int>("verbose");
+    unsigned threads = argparse.get<int>("threads");
+    std::string cachefile = argparse.get("cache");
+    bool renaming = argparse.get<bool>("renaming");
+    bool simd = argparse.get<bool>("simd");
+    std::string features = argparse.get("features");
+    bool approximate = argparse.get<bool>("approximate");
+    unsigned sample = argparse.get<int>("sample");
 
-    if (toolname == "gbdhash") {
-        std::cout << gbd_hash_from_dimacs(filename.c_str()) << std::endl;
+    if (toolname == "gbdhash" || toolname == "fasthash" || toolname == "permhash") {
+        std::unique_ptr<HashCache> cache(cachefile.empty() || toolname != "gbdhash" ? nullptr : new HashCache(cachefile));
+        std::function<std::string(const char*)> hash_function = gbd_hash_from_dimacs;
+        if (toolname == "fasthash") {
+            hash_function = fast_hash_from_dimacs;
+        } else if (toolname == "permhash") {
+            hash_function = [renaming] (const char* filename) {
+                return renaming ? renaming_invariant_hash_from_dimacs(filename) : permutation_invariant_hash_from_dimacs(filename);
+            };
+        }
+        if (files.empty() && filename != "-" && !std::filesystem::is_directory(filename)) {
+            std::cout << cached_hash(filename.c_str(), cache.get(), hash_function) << std::endl;
+        } else {
+            files.insert(files.begin(), filename);
+            if (simd && toolname == "gbdhash") {
+                return gbd_hash_batch_lanes(files, threads, std::cout, cache.get()) > 0 ? 1 : 0;
+            }
+            return hash_batch(files, threads, std::cout, hash_function, cache.get()) > 0 ? 1 : 0;
+        }
+    } else if (toolname == "verify") {
+        std::ifstream manifest_file;
+        if (filename != "-") {
+            manifest_file.open(filename);
+            if (!manifest_file) {
+                std::cerr << "Error opening manifest " << filename << std::endl;
+                return 2;
+            }
+        }
+        VerifyResult result = verify_manifest(filename == "-" ? std::cin : manifest_file, threads, std::cout);
+        std::cerr << "Verified " << result.checked << " files: " << result.mismatched << " mismatched, "
+            << result.missing << " missing, " << result.failed << " unreadable, "
+            << result.malformed << " malformed manifest lines" << std::endl;
+        return result.ok() ? 0 : 1;
+    } else if (toolname == "wlhash") {
+        CNFFormula formula;
+        formula.readDimacsFromFile(filename.c_str());
+        WLFingerprint wl(formula, limits, threads);
+        try {
+            wl.analyze();
+        } catch (ResourceLimitsExceeded& e) {
+            std::cout << "wl_fingerprint=" << (limits.within_memory_limit() ? "timeout" : "memout") << std::endl;
+            return 1;
+        }
+        std::cout << "wl_fingerprint=" << wl.fingerprint() << std::endl;
+        std::cout << "wl_rounds=" << wl.rounds() << std::endl;
     } else if (toolname == "normalize") {
         std::cerr << "Normalizing " << filename << std::endl;
         normalize(filename.c_str());
@@ -95,13 +192,72 @@ int main(int argc, char** argv) {
         std::cerr << "Generating Independent Set Problem " << filename << std::endl;
         generate_independent_set_problem(filename);
     } else if (toolname == "extract") {
+        try {
+            // validate before reading the formula
+            if (approximate) {
+                ApproxCNFStats::parse_groups(features);
+            } else {
+                CNFStats::parse_groups(features);
+            }
+        } catch (const std::invalid_argument& e) {
+            std::cerr << e.what() << std::endl;
+            return 1;
+        }
+        if (approximate) {
+            ApproxCNFStats stats(filename.c_str(), limits, sample, features);
+            bool exceeded = false, memout = false;
+            try {
+                stats.analyze();
+            } catch (ResourceLimitsExceeded& e) {
+                exceeded = true;
+                memout = !limits.within_memory_limit();
+            } catch (std::bad_alloc& e) {
+                exceeded = memout = true;
+            }
+            // completed groups (all of them, or those finished before the limits were exceeded)
+            std::vector<float> record = stats.BaseFeatures();
+            std::vector<float> errors = stats.BaseFeatureErrors();
+            std::vector<float> biases = stats.BaseFeatureBiases();
+            std::vector<std::string> names = stats.FeatureNames();
+            for (unsigned i = 0; i + 1 < record.size(); i++) {
+                std::cout << names[i] << "=" << record[i] << std::endl;
+                std::cout << names[i] << "_error=" << errors[i] << std::endl;
+                if (ApproxCNFStats::HasBias(names[i])) std::cout << names[i] << "_bias=" << biases[i] << std::endl;
+            }
+            if (exceeded) {
+                std::cout << "base_features_runtime=" << (memout ? "memout" : "timeout") << std::endl;
+                std::cout << "base_features_stopped_at=" << stats.StoppedAt() << std::endl;
+                return 1;
+            }
+            std::cout << "base_features_runtime=" << record.back() << std::endl;
+            return 0;
+        }
         CNFFormula formula;
         formula.readDimacsFromFile(filename.c_str());
 
-        CNFStats stats(formula, limits);
-        stats.analyze();
+        CNFStats stats(formula, limits, threads, features);
+        bool exceeded = false, memout = false;
+        try {
+            stats.analyze();
+        } catch (ResourceLimitsExceeded& e) {
+            exceeded = true;
+            memout = !limits.within_memory_limit();
+        } catch (std::bad_alloc& e) {
+            exceeded = memout = true;
+        }
+        if (exceeded) {
+            // report completed groups (without runtime)
+            std::vector<float> record = stats.BaseFeatures();
+            std::vector<std::string> names = stats.FeatureNames();
+            for (unsigned i = 0; i + 1 < record.size(); i++) {
+                std::cout << names[i] << "=" << record[i] << std::endl;
+            }
+            std::cout << "base_features_runtime=" << (memout ? "memout" : "timeout") << std::endl;
+            std::cout << "base_features_stopped_at=" << stats.StoppedAt() << std::endl;
+            return 1;
+        }
         std::vector<float> record = stats.BaseFeatures();
-        std::vector<std::string> names = CNFStats::BaseFeatureNames();
+        std::vector<std::string> names = stats.FeatureNames();
         for (unsigned i = 0; i < record.size(); i++) {
             std::cout << names[i] << "=" << record[i] << std::endl;
         }
@@ -123,7 +279,7 @@ int main(int argc, char** argv) {
         GateStats stats(formula, limits);
         stats.analyze(repeat, verbose);
         std::set<unsigned int> gate_list = stats.GateList();
-        for(std::__1::set<unsigned int>::iterator it = gate_list.begin(); it != gate_list.end(); it++){
+        for(std::set<unsigned int>::iterator it = gate_list.begin(); it != gate_list.end(); it++){
             std::cout << *it << std::endl;
         }
     }
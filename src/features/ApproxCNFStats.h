@@ -0,0 +1,500 @@
+/*************************************************************************************************
+CNFTools -- Copyright (c) 2021, Markus Iser, KIT - Karlsruhe Institute of Technology
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT
+OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ **************************************************************************************************/
+#ifndef SRC_FEATURES_APPROXCNFSTATS_H_
+#define SRC_FEATURES_APPROXCNFSTATS_H_
+
+#include <math.h>
+
+#include <vector>
+#include <array>
+#include <initializer_list>
+#include <map>
+#include <unordered_map>
+#include <random>
+#include <string>
+#include <stdexcept>
+#include <algorithm>
+#include <limits>
+
+#include "src/util/SolverTypes.h"
+#include "src/util/StreamBuffer.h"
+#include "src/util/ResourceLimits.h"
+#include "src/util/Sketches.h"
+
+#include "src/features/CNFStats.h"
+#include "src/features/Util.h"
+
+/**
+ * Approximate base features (same names as CNFStats) for instances which do not fit into memory,
+ * computed in a streaming pass over the DIMACS file in bounded memory:
+ * - clause-level features (sizes, horn counts, balance_clause, vcg_cdegrees) are exact,
+ * - variable-level distributions are estimated from an adaptive hash-based sample of variables
+ *   (counted exactly from their first occurrence, at most sample_size variables), scaled by
+ *   a HyperLogLog estimate of the number of occurring variables,
+ * - the maximum number of occurrences of a variable is bounded below by the exactly counted sample and above by
+ *   a count-min sketch (width four times the sample size),
+ * - clause graph degrees are calculated for a reservoir sample of clauses, based on the exact occurrences
+ *   of their literals which are counted in a second pass (only if group cg is selected).
+ * Groups on the implication graph or the variable incidence graph (e.g. clustering) and search probes are not available
+ * in this mode.
+ * Each feature comes with an error estimate (0 if exact, NaN if no estimate is available): the standard error for
+ * mean, variance and entropy, a 95% bound for quantiles (ranks by the Dvoretzky-Kiefer-Wolfowitz inequality, mapped
+ * to values, or the relative accuracy of the quantile sketch), and for the maximum number of occurrences the distance
+ * of the exact lower bound (the reported value) to the count-min upper bound.
+ * The plug-in entropy estimate is biased low; its Miller-Madow bias estimate (negative) is reported separately.
+ * If the limits are exceeded, the groups completed so far can still be reported (as in CNFStats).
+ */
+class ApproxCNFStats {
+    struct VariableCounts {
+        unsigned pos = 0, neg = 0;  // literal occurrences
+        unsigned horn = 0, inv_horn = 0;  // occurrences in (inv.) horn clauses
+        unsigned degree = 0;  // VG degree (accumulated as in CNFStats)
+    };
+
+    // Estimated statistics of a distribution in the order of push_distribution and push_quantiles
+    struct Estimate {
+        static constexpr unsigned size = 8;
+        std::array<double, size> value {}, error {}, bias {};
+        enum { MEAN, VARIANCE, MIN, MAX, ENTROPY, MEDIAN, P90, P99 };
+    };
+
+    static constexpr double confidence = 0.95;  // of quantile error bounds
+
+    const char* filename_;
+    const ResourceLimits& limits_;
+    size_t sample_size_;
+    std::vector<bool> selected_, completed_;
+    std::vector<std::vector<float>> values_, errors_, biases_;  // one record per group
+    float runtime_ = 0;
+
+    static inline bool sampled(unsigned var, unsigned level) {
+        return (mix64(var, 0x5a3c) & ((uint64_t(1) << level) - 1)) == 0;
+    }
+
+    /**
+     * Estimates the statistics of a population of values from a uniform sample, where the sample represents
+     * `represented` (+- represented_error) members of the population and all other members are zero.
+     * Errors combine the sampling error and the effect of the error of `represented`.
+     */
+    static Estimate estimate(const std::vector<double>& sample, double represented, double represented_error, double population, bool integral) {
+        Estimate result;
+        const double m = sample.size();
+        if (m == 0 || population <= 0) return result;
+
+        double sum = 0, sumsq = 0, min = sample[0], max = sample[0];
+        std::map<long, double> frequency;
+        for (double x : sample) {
+            sum += x;
+            sumsq += x * x;
+            min = std::min(min, x);
+            max = std::max(max, x);
+            frequency[integral ? std::lround(x) : std::lround(10 * x)] += 1;
+        }
+        std::vector<double> sorted(sample);
+        std::sort(sorted.begin(), sorted.end());
+        // population member at index floor(q * (population - 1)), where the zeros (non-negative values) come first
+        auto quantile = [&] (double represented, double q) {
+            const double weight = represented / m, zeros = std::max(0.0, population - represented);
+            const double index = floor(std::min(1.0, std::max(0.0, q)) * (population - 1) + 1e-9);
+            if (index < zeros) return 0.0;
+            return sorted[std::min<size_t>(sorted.size() - 1, static_cast<size_t>((index - zeros) / weight))];
+        };
+        const double quantiles[] = { 0.5, 0.9, 0.99 };
+        auto statistics = [&] (double represented) {
+            const double weight = represented / m, zeros = std::max(0.0, population - represented);
+            std::array<double, Estimate::size> value;
+            value[Estimate::MEAN] = weight * sum / population;
+            value[Estimate::VARIANCE] = std::max(0.0, weight * sumsq / population - value[Estimate::MEAN] * value[Estimate::MEAN]);
+            value[Estimate::MIN] = zeros >= 0.5 ? 0 : min;
+            value[Estimate::MAX] = max;
+            double entropy = 0;
+            for (auto& bin : frequency) {
+                double p_x = (weight * bin.second + (bin.first == 0 ? zeros : 0)) / population;
+                if (p_x > 0) entropy -= p_x * log(p_x) / log(2);
+            }
+            if (zeros > 0 && frequency.count(0) == 0) {
+                double p_x = zeros / population;
+                entropy -= p_x * log(p_x) / log(2);
+            }
+            value[Estimate::ENTROPY] = entropy;
+            for (unsigned i = 0; i < 3; i++) {
+                value[Estimate::MEDIAN + i] = quantile(represented, quantiles[i]);
+            }
+            return value;
+        };
+        result.value = statistics(represented);
+
+        const double fpc = std::max(0.0, 1 - m / represented);  // finite population correction
+        if (fpc > 0 || represented_error > 0) {
+            const double mean = sum / m, variance = m > 1 ? std::max(0.0, (sumsq - m * mean * mean) / (m - 1)) : 0;
+            const double share = represented / population;
+            result.error[Estimate::MEAN] = share * sqrt(variance / m * fpc);
+            result.error[Estimate::VARIANCE] = result.value[Estimate::VARIANCE] * sqrt(2 / std::max(1.0, m - 1) * fpc);
+            result.error[Estimate::MIN] = result.value[Estimate::MIN] == 0 ? 0 : std::numeric_limits<double>::quiet_NaN();
+            result.error[Estimate::MAX] = fpc > 0 ? std::numeric_limits<double>::quiet_NaN() : 0;
+            // entropy: delta method over the sampled frequencies (d entropy / d frequency of x = -share * log2 p_x + c)
+            double first = 0, second = 0;
+            for (auto& bin : frequency) {
+                const double p_x = (share * bin.second / m + (bin.first == 0 ? 1 - share : 0));
+                const double g = log(p_x) / log(2), pi = bin.second / m;
+                first += pi * g;
+                second += pi * g * g;
+            }
+            result.error[Estimate::ENTROPY] = share * sqrt(std::max(0.0, second - first * first) / m * fpc);
+            result.bias[Estimate::ENTROPY] = (1.0 - frequency.size()) * share / (2 * m * log(2)) * fpc;  // Miller-Madow
+            // quantiles: the sample distribution function is within epsilon of the represented members' one
+            // with probability confidence (Dvoretzky-Kiefer-Wolfowitz), scaled to population ranks
+            const double epsilon = sqrt(log(2 / (1 - confidence)) / (2 * m) * fpc) * share;
+            for (unsigned i = 0; i < 3; i++) {
+                const double q = quantiles[i], value = result.value[Estimate::MEDIAN + i];
+                result.error[Estimate::MEDIAN + i] = std::max(quantile(represented, q + epsilon) - value, value - quantile(represented, q - epsilon));
+            }
+            if (represented_error > 0) {  // propagate the error of the number of represented members
+                std::array<double, Estimate::size> lower = statistics(std::max(m, represented - represented_error));
+                std::array<double, Estimate::size> upper = statistics(std::min(population, represented + represented_error));
+                for (unsigned i : { Estimate::MEAN, Estimate::VARIANCE, Estimate::ENTROPY, Estimate::MEDIAN, Estimate::P90, Estimate::P99 }) {
+                    result.error[i] = sqrt(pow(result.error[i], 2) + pow((upper[i] - lower[i]) / 2, 2));
+                }
+            }
+        }
+        return result;
+    }
+
+    // Reads the next clause without redundant literals, returns false for tautologies (as CNFFormula)
+    static bool read_clause(StreamBuffer* in, Cl* clause) {
+        clause->clear();
+        for (int plit = in->readInteger(); plit != 0; plit = in->readInteger()) {
+            clause->push_back(Lit(abs(plit), plit < 0));
+        }
+        std::sort(clause->begin(), clause->end());
+        clause->erase(std::unique(clause->begin(), clause->end()), clause->end());
+        return std::adjacent_find(clause->begin(), clause->end(), [] (Lit a, Lit b) { return a.var() == b.var(); }) == clause->end();
+    }
+
+    // Record of values, errors and biases of a group
+    struct Record {
+        std::vector<float> values, errors, biases;
+
+        // features without error and bias
+        void push_exact(std::initializer_list<float> exact) {
+            values.insert(values.end(), exact);
+            errors.resize(values.size(), 0);
+            biases.resize(values.size(), 0);
+        }
+
+        void push(const Estimate& estimate) {
+            for (unsigned i = 0; i < Estimate::size; i++) {
+                values.push_back(static_cast<float>(estimate.value[i]));
+                errors.push_back(static_cast<float>(estimate.error[i]));
+                biases.push_back(static_cast<float>(estimate.bias[i]));
+            }
+        }
+
+        // statistics of a distribution of all samples (only quantiles of floating point samples can have errors)
+        template <typename T>
+        void push(const Distribution<T>& exact) {
+            push_distribution(&values, exact);
+            errors.resize(values.size(), 0);
+            for (double q : { 0.5, 0.9, 0.99 }) {
+                values.push_back(exact.quantile(q));
+                errors.push_back(static_cast<float>(exact.quantile_error(q)));
+            }
+            biases.resize(values.size(), 0);
+        }
+    };
+
+    void commit(unsigned group, Record* record) {
+        values_[group].swap(record->values);
+        errors_[group].swap(record->errors);
+        biases_[group].swap(record->biases);
+        *record = Record();
+        completed_[group] = true;
+    }
+
+ public:
+    /**
+     * @throws std::invalid_argument for groups selected by name which are not supported (see parse_groups())
+     */
+    explicit ApproxCNFStats(const char* filename, const ResourceLimits& limits, size_t sample_size = 1 << 16, const std::string& groups = "") :
+     filename_(filename), limits_(limits), sample_size_(std::max<size_t>(sample_size, 2)), selected_(parse_groups(groups)),
+     completed_(CNFStats::N_GROUPS, false), values_(CNFStats::N_GROUPS), errors_(CNFStats::N_GROUPS), biases_(CNFStats::N_GROUPS) {
+    }
+
+    /**
+     * Groups as in CNFStats::parse_groups() restricted to the groups up to cg (graph and search groups need the
+     * whole formula): groups after cg are dropped from the defaults and from "all", but rejected if given by name
+     * @throws std::invalid_argument for unknown or unsupported group names
+     */
+    static std::vector<bool> parse_groups(const std::string& spec) {
+        std::vector<bool> selected = CNFStats::parse_groups(spec);
+        const std::vector<CNFStats::FeatureGroup>& groups = CNFStats::FeatureGroups();
+        for (unsigned g = CNFStats::CG + 1; g < CNFStats::N_GROUPS; g++) {
+            if (selected[g] && ("," + spec + ",").find("," + groups[g].name + ",") != std::string::npos) {
+                throw std::invalid_argument("Feature group not supported in approximate mode: " + groups[g].name);
+            }
+            selected[g] = false;
+        }
+        return selected;
+    }
+
+    /**
+     * @throws ResourceLimitsExceeded (groups are completed in order, see StoppedAt())
+     */
+    void analyze() {
+        limits_.within_limits_or_throw();
+
+        // exact clause-level statistics
+        uint64_t n_clauses = 0, n_literals = 0;
+        unsigned n_vars = 0;
+        std::array<unsigned, 10> clause_sizes {};
+        unsigned horn = 0, inv_horn = 0, positive = 0, negative = 0;
+        Distribution<unsigned> clause_occurrences;
+        Distribution<float> pos_neg_per_clause;
+
+        // sketches and samples
+        const bool vcg = selected_[CNFStats::VCG], cg = selected_[CNFStats::CG];
+        HyperLogLog variables;
+        const unsigned width = vcg ? 1u << std::min(24, 2 + static_cast<int>(ceil(log2(sample_size_)))) : 1;
+        CountMinSketch variable_occurrences(width);
+        uint32_t max_occurrences = 0;
+        std::unordered_map<unsigned, VariableCounts> sample;
+        unsigned level = 0;  // variables are sampled with probability 2^-level
+        std::vector<Cl> reservoir;
+        std::mt19937_64 random(0);
+
+        StreamBuffer in(filename_);
+        Cl clause;
+        while (!in.eof()) {
+            in.skipWhitespace();
+            if (in.eof()) {
+                break;
+            }
+            if (*in == 'p' || *in == 'c') {
+                in.skipLine();
+                continue;
+            }
+            if (!read_clause(&in, &clause)) continue;
+
+            if (++n_clauses % (1 << 16) == 0) {
+                limits_.within_limits_or_throw();
+            }
+            const unsigned size = clause.size();
+            const unsigned neg = count_negative(clause);
+            const bool is_horn = neg <= 1, is_inv_horn = size - neg <= 1;
+            if (size > 0) n_vars = std::max(n_vars, static_cast<unsigned>(clause.back().var()));
+            if (size < 10) ++clause_sizes[size];
+            clause_occurrences.add(size);
+            if (is_horn) {
+                if (neg == 0) ++positive;
+                ++horn;
+            }
+            if (is_inv_horn) {
+                if (size - neg == 0) ++negative;
+                ++inv_horn;
+            }
+            float pos = size - neg;
+            pos_neg_per_clause.add(std::max<float>(pos, neg) > 0 ? std::min<float>(pos, neg) / std::max<float>(pos, neg) : 0);
+
+            n_literals += size;
+            for (Lit lit : clause) {
+                unsigned var = lit.var();
+                variables.add(mix64(var));
+                if (vcg) max_occurrences = std::max(max_occurrences, variable_occurrences.add(var));
+                if (sampled(var, level)) {
+                    VariableCounts& counts = sample[var];
+                    if (lit.sign()) ++counts.neg; else ++counts.pos;
+                    if (is_horn) ++counts.horn;
+                    if (is_inv_horn) ++counts.inv_horn;
+                    counts.degree += 1.0 / pow(2, size);
+                }
+            }
+            while (sample.size() > sample_size_) {  // halve the sampling rate
+                ++level;
+                for (auto it = sample.begin(); it != sample.end(); ) {
+                    it = sampled(it->first, level) ? std::next(it) : sample.erase(it);
+                }
+            }
+
+            // reservoir sampling of clauses (algorithm R)
+            if (!cg) {
+                continue;
+            } else if (reservoir.size() < sample_size_) {
+                reservoir.push_back(clause);
+            } else {
+                uint64_t slot = random() % n_clauses;
+                if (slot < sample_size_) reservoir[slot] = clause;
+            }
+        }
+
+        // variables 0..n_vars as in CNFStats, of which the sample represents those which occur
+        const double population = n_vars + 1;
+        double occurring = sample.size(), occurring_error = 0;
+        if (level > 0) {
+            // inverse-variance weighted combination of the scaled sample size and the HyperLogLog estimate
+            double scaled = ldexp(sample.size(), level), scaled_variance = std::max(1.0, scaled * (ldexp(1.0, level) - 1));
+            double counted = variables.estimate(), counted_variance = std::max(1.0, pow(counted * variables.relative_error(), 2));
+            occurring_error = sqrt(1 / (1 / scaled_variance + 1 / counted_variance));
+            occurring = (scaled / scaled_variance + counted / counted_variance) * occurring_error * occurring_error;
+            occurring = std::min<double>(n_vars, std::max<double>(sample.size(), occurring));  // variable 0 does not occur
+        }
+        std::vector<double> occurrences, horn_occurrences, inv_horn_occurrences, degrees, balance;
+        for (auto& entry : sample) {
+            const VariableCounts& counts = entry.second;
+            occurrences.push_back(counts.pos + counts.neg);
+            horn_occurrences.push_back(counts.horn);
+            inv_horn_occurrences.push_back(counts.inv_horn);
+            degrees.push_back(counts.degree);
+            float pos = counts.pos, neg = counts.neg;
+            balance.push_back(std::max(pos, neg) > 0 ? std::min(pos, neg) / std::max(pos, neg) : 0);
+        }
+        // maximum occurrences if variables are sampled: the sample maximum (counted exactly) is a lower bound,
+        // the count-min sketch maximum an upper bound (the sketch never underestimates)
+        auto with_max = [level] (Estimate estimate, uint32_t upper) {
+            if (level > 0) {
+                estimate.error[Estimate::MAX] = std::max(0.0, upper - estimate.value[Estimate::MAX]);
+            }
+            return estimate;
+        };
+
+        Record record;
+        if (selected_[CNFStats::SIZES]) {
+            record.push_exact({ static_cast<float>(n_clauses), static_cast<float>(n_vars) });
+            for (unsigned i = 1; i < 10; ++i) {
+                record.push_exact({ static_cast<float>(clause_sizes[i]) });
+            }
+            commit(CNFStats::SIZES, &record);
+        }
+        if (selected_[CNFStats::HORN]) {
+            record.push_exact({ static_cast<float>(horn), static_cast<float>(inv_horn), static_cast<float>(positive), static_cast<float>(negative) });
+            record.push(estimate(horn_occurrences, occurring, occurring_error, population, true));
+            record.push(estimate(inv_horn_occurrences, occurring, occurring_error, population, true));
+            commit(CNFStats::HORN, &record);
+        }
+        if (selected_[CNFStats::VG]) {
+            record.push(estimate(degrees, occurring, occurring_error, population, true));
+            commit(CNFStats::VG, &record);
+        }
+        if (selected_[CNFStats::BALANCE]) {
+            record.push(pos_neg_per_clause);
+            record.push(estimate(balance, occurring, occurring_error, population, false));
+            commit(CNFStats::BALANCE, &record);
+        }
+        if (selected_[CNFStats::VCG]) {
+            record.push(with_max(estimate(occurrences, occurring, occurring_error, population, true), max_occurrences));
+            record.push(clause_occurrences);
+            commit(CNFStats::VCG, &record);
+        }
+        if (selected_[CNFStats::CG]) {
+            // second pass: exact occurrences of the complements of the literals in sampled clauses
+            std::unordered_map<unsigned, unsigned> complement_occurrences;
+            for (const Cl& sampled_clause : reservoir) {
+                for (Lit lit : sampled_clause) complement_occurrences[~lit] = 0;
+            }
+            StreamBuffer in(filename_);
+            uint64_t n_read = 0;
+            while (!in.eof()) {
+                in.skipWhitespace();
+                if (in.eof()) {
+                    break;
+                }
+                if (*in == 'p' || *in == 'c') {
+                    in.skipLine();
+                    continue;
+                }
+                if (!read_clause(&in, &clause)) continue;
+                if (++n_read % (1 << 16) == 0) {
+                    limits_.within_limits_or_throw();
+                }
+                for (Lit lit : clause) {
+                    auto it = complement_occurrences.find(lit);
+                    if (it != complement_occurrences.end()) ++it->second;
+                }
+            }
+            std::vector<double> clause_degrees;
+            for (const Cl& sampled_clause : reservoir) {
+                unsigned degree = 0;
+                for (Lit lit : sampled_clause) {
+                    degree += complement_occurrences[~lit];
+                }
+                clause_degrees.push_back(degree);
+            }
+            record.push(estimate(clause_degrees, n_clauses, 0, n_clauses, true));
+            commit(CNFStats::CG, &record);
+        }
+
+        runtime_ = static_cast<float>(limits_.get_runtime());
+    }
+
+    // Name of the first selected group which is not completed (empty if all are completed)
+    std::string StoppedAt() const {
+        for (unsigned g = 0; g < CNFStats::N_GROUPS; g++) {
+            if (selected_[g] && !completed_[g]) return CNFStats::FeatureGroups()[g].name;
+        }
+        return "";
+    }
+
+    // Features of the completed groups followed by the runtime
+    std::vector<float> BaseFeatures() const {
+        std::vector<float> record;
+        for (const std::vector<float>& values : values_) {
+            record.insert(record.end(), values.begin(), values.end());
+        }
+        record.push_back(runtime_);
+        return record;
+    }
+
+    // Estimated errors of BaseFeatures()
+    std::vector<float> BaseFeatureErrors() const {
+        std::vector<float> record;
+        for (const std::vector<float>& errors : errors_) {
+            record.insert(record.end(), errors.begin(), errors.end());
+        }
+        record.push_back(0);
+        return record;
+    }
+
+    // Estimated biases of BaseFeatures() (non-zero for entropies only, see HasBias())
+    std::vector<float> BaseFeatureBiases() const {
+        std::vector<float> record;
+        for (const std::vector<float>& biases : biases_) {
+            record.insert(record.end(), biases.begin(), biases.end());
+        }
+        record.push_back(0);
+        return record;
+    }
+
+    // Whether a bias is reported for the feature of the given name (<name>_bias)
+    static bool HasBias(const std::string& name) {
+        const std::string suffix = "_entropy";
+        return name.size() > suffix.size() && name.compare(name.size() - suffix.size(), suffix.size(), suffix) == 0;
+    }
+
+    // Names of BaseFeatures()
+    std::vector<std::string> FeatureNames() const {
+        std::vector<std::string> names;
+        for (unsigned g = 0; g < CNFStats::N_GROUPS; g++) if (completed_[g]) {
+            const std::vector<std::string>& features = CNFStats::FeatureGroups()[g].features;
+            names.insert(names.end(), features.begin(), features.end());
+        }
+        names.push_back("base_features_runtime");
+        return names;
+    }
+};
+
+#endif  // SRC_FEATURES_APPROXCNFSTATS_H_
@@ -0,0 +1,127 @@
+/*************************************************************************************************
+CNFTools -- Copyright (c) 2021, Markus Iser, KIT - Karlsruhe Institute of Technology
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT
+OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ **************************************************************************************************/
+
+#ifndef SRC_FEATURES_CDCLPROBE_H_
+#define SRC_FEATURES_CDCLPROBE_H_
+
+#include <chrono>
+#include <climits>
+#include <cstdint>
+#include <vector>
+
+#include "lib/ipasir.h"
+
+#include "src/util/SolverTypes.h"
+#include "src/util/CNFFormula.h"
+#include "src/util/ResourceLimits.h"
+
+#include "src/features/Util.h"
+
+/**
+ * Search space probing (cf. SATzilla's DPLL probes) with an IPASIR solver: the formula is loaded once and
+ * solved in a few rounds, each of which is stopped by the terminate callback after a fixed number of conflicts.
+ * IPASIR exposes no conflict counter and no decision levels, so conflicts are counted as learned clauses
+ * (learn callback without length limit), and short learned clauses (size <= 2, thus glue <= 2) serve as LBD proxy.
+ * Progress is measured by the variables fixed by learned units after each round. Budgets are counted in conflicts,
+ * not in time, such that all features except conflicts per second are reproducible.
+ */
+class CDCLProbe {
+    const CNFFormula& formula_;
+    const ResourceLimits& limits_;
+    void* solver_;
+
+    uint64_t budget_ = 0;
+    uint64_t polls_ = 0;
+    bool exceeded_ = false;
+    std::vector<bool> fixed_;
+    unsigned n_fixed_ = 0;
+
+    static int terminate(void* data) {
+        CDCLProbe* probe = static_cast<CDCLProbe*>(data);
+        if (probe->conflicts >= probe->budget_) return 1;
+        if ((++probe->polls_ & 0x3FF) == 0 && !probe->limits_.within_limits()) probe->exceeded_ = true;
+        return probe->exceeded_;
+    }
+
+    static void learn(void* data, int32_t* clause) {
+        CDCLProbe* probe = static_cast<CDCLProbe*>(data);
+        unsigned size = 0;
+        while (clause[size] != 0) ++size;
+        ++probe->conflicts;
+        probe->learned_sizes.add(size);
+        if (size <= 2) ++probe->learned_short;
+        if (size == 1) {
+            unsigned var = clause[0] < 0 ? -clause[0] : clause[0];
+            if (var < probe->fixed_.size() && !probe->fixed_[var]) {
+                probe->fixed_[var] = true;
+                ++probe->n_fixed_;
+            }
+        }
+    }
+
+ public:
+    static constexpr uint64_t default_conflicts = 1 << 14;
+    static constexpr unsigned default_rounds = 4;
+
+    int status = 0;  // ipasir_solve result of the last round (10: sat, 20: unsat, 0: budget exhausted)
+    uint64_t conflicts = 0;
+    uint64_t learned_short = 0;  // learned clauses of size <= 2
+    double seconds = 0;  // solver time
+    std::vector<float> fixed;  // fraction of variables fixed by learned units after each round
+    Distribution<unsigned> learned_sizes;
+
+    CDCLProbe(const CNFFormula& formula, const ResourceLimits& limits) :
+     formula_(formula), limits_(limits), solver_(ipasir_init()), fixed_(formula.nVars() + 1, false) {
+        ipasir_set_terminate(solver_, this, terminate);
+        ipasir_set_learn(solver_, this, INT_MAX, learn);
+    }
+
+    ~CDCLProbe() {
+        ipasir_release(solver_);
+    }
+
+    CDCLProbe(const CDCLProbe&) = delete;
+    CDCLProbe& operator=(const CDCLProbe&) = delete;
+
+    /**
+     * Solves in the given number of rounds with conflicts / rounds conflicts each (stops early if solved)
+     * @throws ResourceLimitsExceeded
+     */
+    void analyze(uint64_t budget = default_conflicts, unsigned rounds = default_rounds) {
+        for (const Cl* clause : formula_) {
+            for (Lit lit : *clause) {
+                ipasir_add(solver_, lit.toDimacs());
+            }
+            ipasir_add(solver_, 0);
+        }
+        limits_.within_limits_or_throw();
+        for (unsigned round = 0; round < rounds; round++) {
+            if (status == 0) {
+                budget_ += budget / rounds;
+                auto start = std::chrono::steady_clock::now();
+                status = ipasir_solve(solver_);
+                seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+                if (exceeded_) throw ResourceLimitsExceeded();
+            }
+            fixed.push_back(formula_.nVars() > 0 ? static_cast<float>(n_fixed_) / formula_.nVars() : 0);
+        }
+    }
+};
+
+#endif  // SRC_FEATURES_CDCLPROBE_H_
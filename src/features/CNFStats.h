@@ -23,198 +23,617 @@ OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWA
 
 #include <vector>
 #include <array>
+#include <chrono>
 #include <iostream>
 #include <algorithm>
 #include <numeric>
 #include <string>
+#include <sstream>
+#include <stdexcept>
 
 #include "src/util/SolverTypes.h"
 #include "src/util/CNFFormula.h"
 #include "src/util/ResourceLimits.h"
+#include "src/util/ThreadPool.h"
+#include "src/util/CSRGraph.h"
 
 #include "src/features/Util.h"
+#include "src/features/CDCLProbe.h"
+#include "src/features/Clustering.h"
+#include "src/features/Communities.h"
+#include "src/features/ImplicationGraph.h"
+#include "src/features/LocalSearch.h"
+#include "src/features/PowerLaw.h"
+#include "src/features/Propagation.h"
+#include "src/features/Spectral.h"
+#include "src/features/Treewidth.h"
 
 // Calculate Subset of Satzilla Features + Other CNF Stats
 // CF. 2004, Nudelmann et al., Understanding Random SAT - Beyond the Clause-to-Variable Ratio
 class CNFStats {
+ public:
+    // Feature groups (in record order) and the intermediates they depend on
+    enum Group : unsigned { SIZES, HORN, VG, BALANCE, VCG, CG, BINARY, POWERLAW, CLUSTERING, COMMUNITY, SPECTRAL, TREEWIDTH, LOCALSEARCH, CDCL, PROPAGATION, N_GROUPS };
+    enum Intermediate : unsigned { NONE = 0, LITERAL_OCCURRENCES = 1, VIG = 2 };
+
+    struct FeatureGroup {
+        std::string name;
+        bool default_on;
+        unsigned depends;  // intermediates
+        std::vector<std::string> features;
+    };
+
+    static const std::vector<FeatureGroup>& FeatureGroups() {
+        static const std::vector<FeatureGroup> groups {
+            { "sizes", true, NONE, { "clauses", "variables",
+                "clause_size_1", "clause_size_2", "clause_size_3", "clause_size_4", "clause_size_5", "clause_size_6", "clause_size_7", "clause_size_8", "clause_size_9" } },
+            { "horn", true, NONE, concat({ { "horn_clauses", "inv_horn_clauses", "positive_clauses", "negative_clauses" },
+                statistics_names("horn_vars"), statistics_names("inv_horn_vars") }) },
+            { "vg", true, NONE, statistics_names("vg_degrees") },
+            { "balance", true, LITERAL_OCCURRENCES, concat({ statistics_names("balance_clause"), statistics_names("balance_vars") }) },
+            { "vcg", true, LITERAL_OCCURRENCES, concat({ statistics_names("vcg_vdegrees"), statistics_names("vcg_cdegrees") }) },
+            { "cg", true, LITERAL_OCCURRENCES, statistics_names("cg_degrees") },
+            { "binary", true, NONE, concat({ { "bin_unsat", "bin_equivalence_classes", "bin_equivalent_literals", "bin_depth" },
+                statistics_names("bin_scc_sizes") }) },
+            { "powerlaw", false, LITERAL_OCCURRENCES, { "pl_alpha", "pl_alpha_error", "pl_xmin", "pl_tail", "pl_ks" } },
+            { "clustering", false, VIG, concat({ { "vig_triangles", "vig_triangles_error", "vig_transitivity", "vig_transitivity_error" },
+                statistics_names("vig_clustering") }) },
+            { "community", false, VIG, concat({ { "vig_modularity", "vig_communities", "vig_community_levels" },
+                statistics_names("vig_community_sizes") }) },
+            { "spectral", false, VIG, { "vig_spectral_radius", "vig_lambda_2", "vig_spectral_gap",
+                "vcg_spectral_radius", "vcg_lambda_2", "vcg_spectral_gap" } },
+            { "treewidth", false, VIG, { "tw_lower_bound", "tw_min_degree", "tw_min_fill", "tw_upper_bound", "tw_exceeded" } },
+            { "localsearch", false, NONE, { "ls_best_unsat_min", "ls_best_unsat_mean", "ls_best_flip_mean",
+                "ls_unsat_mean", "ls_autocorrelation", "ls_solved" } },
+            { "cdcl", false, NONE, concat({ { "cdcl_status", "cdcl_conflicts", "cdcl_conflicts_per_second", "cdcl_learned_short_fraction" },
+                statistics_names("cdcl_learned_size"), { "cdcl_fixed_1", "cdcl_fixed_2", "cdcl_fixed_3", "cdcl_fixed_4" } }) },
+            { "propagation", false, NONE, concat({ { "prop_root_conflict", "prop_root_fixed", "prop_probed", "prop_failed_literals" },
+                statistics_names("prop_implications"), statistics_names("prop_depth"), { "propagation_runtime" } }) }
+        };
+        return groups;
+    }
+
+    /**
+     * Parses a comma-separated list of group names ("all" for all groups, empty for the default groups)
+     * @throws std::invalid_argument for unknown group names
+     */
+    static std::vector<bool> parse_groups(const std::string& spec) {
+        const std::vector<FeatureGroup>& groups = FeatureGroups();
+        std::vector<bool> selected(groups.size(), false);
+        if (spec.empty()) {
+            for (unsigned g = 0; g < groups.size(); g++) selected[g] = groups[g].default_on;
+            return selected;
+        }
+        std::stringstream stream(spec);
+        std::string name;
+        while (std::getline(stream, name, ',')) {
+            if (name.empty()) continue;
+            if (name == "all") {
+                selected.assign(groups.size(), true);
+                continue;
+            }
+            auto it = std::find_if(groups.begin(), groups.end(), [&name] (const FeatureGroup& group) { return group.name == name; });
+            if (it == groups.end()) {
+                throw std::invalid_argument("Unknown feature group: " + name);
+            }
+            selected[it - groups.begin()] = true;
+        }
+        return selected;
+    }
+
+ private:
     const CNFFormula& formula_;
     const ResourceLimits& limits_;
-    std::vector<float> record;
+    unsigned threads_;
+    std::vector<bool> selected_;
+    std::vector<bool> completed_;
+    Group running_ = SIZES;  // first group of the running stage
+    std::vector<std::vector<float>> values_;  // one record per group
+    float runtime_ = 0;
+
+    // Intermediates (computed on demand, shared by groups)
+    std::vector<unsigned> literal_occurrences_;
+    CSRGraph vig_;  // variable incidence graph (weighted if needed)
+
+    static std::vector<std::string> concat(std::initializer_list<std::vector<std::string>> parts) {
+        std::vector<std::string> result;
+        for (const std::vector<std::string>& part : parts) result.insert(result.end(), part.begin(), part.end());
+        return result;
+    }
 
- public:
-    unsigned n_vars, n_clauses;
+    // Each distribution is described by its statistics and quantiles
+    static std::vector<std::string> statistics_names(const std::string& prefix) {
+        return concat({ distribution_names(prefix), quantile_names(prefix) });
+    }
 
-    explicit CNFStats(const CNFFormula& formula, const ResourceLimits& limits) :
-     formula_(formula), limits_(limits), record(), n_vars(formula.nVars()), n_clauses(formula.nClauses()) {
+    template <typename T>
+    static void push_statistics(std::vector<float>* record, const Distribution<T>& distribution) {
+        push_distribution(record, distribution);
+        push_quantiles(record, distribution);
     }
 
-    void analyze_occurrences() {
-        // Size
-        std::array<unsigned, 10> clause_sizes;  // one entry per clause-size
+    inline bool selected(Group group) const {
+        return selected_[group];
+    }
 
-        // Horn
-        unsigned horn = 0, inv_horn = 0;  // number of (inv.) horn clauses
-        unsigned positive = 0, negative = 0;  // number of positive / negative clauses
-        std::vector<unsigned> variable_horn, variable_inv_horn;  // occurrences in (inv.) horn clauses (per variable)
-        variable_horn.resize(n_vars + 1);
-        variable_inv_horn.resize(n_vars + 1);
+    bool needs(Intermediate intermediate) const {
+        for (unsigned g = 0; g < N_GROUPS; g++) {
+            if (selected_[g] && (FeatureGroups()[g].depends & intermediate)) return true;
+        }
+        return false;
+    }
 
-        // VCG Node Distribution:
-        std::vector<unsigned> clause_occurrences;  // one entry per clause (its size)
-        std::vector<unsigned> variable_occurrences;  // one entry per variable (its num. of occurrences)
-        variable_occurrences.resize(n_vars + 1);
+    // Calls f(thread, begin, end) for chunks of [0, n), stops if the resource limits are exceeded (see ::for_each_chunk)
+    template<typename Function>
+    void for_each_chunk(size_t n, Function f) const {
+        ::for_each_chunk(n, threads_, limits_, f);
+    }
 
-        for (Cl* clause : formula_) {
-            if (clause->size() < 10) {
-                ++clause_sizes[clause->size()];
+    // Calls f(thread, clause) for all clauses
+    template<typename Function>
+    void for_each_clause(Function f) const {
+        for_each_chunk(n_clauses, [this, &f] (unsigned t, size_t begin, size_t end) {
+            for (auto it = formula_.begin() + begin; it != formula_.begin() + end; ++it) {
+                f(t, *it);
             }
+        });
+    }
 
-            clause_occurrences.push_back(clause->size());
+    // Records the running stage for StoppedAt() and checks the limits before it starts
+    void begin_group(Group group, const char* message) {
+        running_ = group;
+        limits_.within_limits_or_throw();
+        std::cout << message << std::endl;
+    }
 
-            float neg = 0;
-            for (Lit lit : *clause) {
-                ++variable_occurrences[lit.var()];
-                if (lit.sign()) ++neg;
-            }
+    void commit(Group group, std::vector<float>* record) {
+        values_[group].swap(*record);
+        completed_[group] = true;
+    }
+
+ public:
+    unsigned n_vars, n_clauses;
 
-            // horn
-            if (neg <= 1) {
-                if (neg == 0) ++positive;
-                ++horn;
+    explicit CNFStats(const CNFFormula& formula, const ResourceLimits& limits, unsigned threads = 1, const std::string& groups = "") :
+     formula_(formula), limits_(limits), threads_(ThreadPool::resolve(threads)), selected_(parse_groups(groups)),
+     completed_(N_GROUPS, false), values_(N_GROUPS), n_vars(formula.nVars()), n_clauses(formula.nClauses()) {
+    }
+
+    /**
+     * One pass over all clauses for the groups sizes, horn, vg, the clause part of balance and the clause degrees of vcg,
+     * which also counts literal occurrences if any selected group needs them
+     */
+    void analyze_clauses() {
+        begin_group(SIZES, "Analyzing Clauses");
+        const bool sizes = selected(SIZES), horn = selected(HORN), vg = selected(VG), balance = selected(BALANCE), vcg = selected(VCG);
+        const bool occurrences = needs(LITERAL_OCCURRENCES);
+
+        // thread-local counters, reduced after the pass
+        struct Counts {
+            std::array<unsigned, 10> clause_sizes {};  // one entry per clause-size
+            unsigned horn = 0, inv_horn = 0;  // number of (inv.) horn clauses
+            unsigned positive = 0, negative = 0;  // number of positive / negative clauses
+            Distribution<unsigned> clause_occurrences;  // VCG clause node distribution (clause sizes)
+            Distribution<float> pos_neg_per_clause;  // min(pos, neg) / max(pos, neg) literal occurence per clause
+        };
+        std::vector<Counts> counts(threads_);
+
+        auto counters = [this] (bool needed, size_t size) {
+            return std::vector<std::vector<unsigned>>(threads_, std::vector<unsigned>(needed ? size : 0));
+        };
+        // occurrences in (inv.) horn clauses (per variable)
+        std::vector<std::vector<unsigned>> variable_horn = counters(horn, n_vars + 1);
+        std::vector<std::vector<unsigned>> variable_inv_horn = counters(horn, n_vars + 1);
+        // VG node distribution (per variable)
+        std::vector<std::vector<unsigned>> variable_degree = counters(vg, n_vars + 1);
+        // occurrences per literal
+        std::vector<std::vector<unsigned>> literal_occurrences = counters(occurrences, 2 * n_vars + 2);
+
+        for_each_clause([&] (unsigned t, Cl* clause) {
+            Counts& count = counts[t];
+            if (sizes && clause->size() < 10) {
+                ++count.clause_sizes[clause->size()];
+            }
+            if (vcg) {
+                count.clause_occurrences.add(clause->size());
+            }
+            if (occurrences) {
                 for (Lit lit : *clause) {
-                    ++variable_horn[lit.var()];
+                    ++literal_occurrences[t][lit];
                 }
             }
-            if (clause->size() - neg <= 1) {
-                if (clause->size() - neg == 0) ++negative;
-                ++inv_horn;
+            if (vg) {
                 for (Lit lit : *clause) {
-                    ++variable_inv_horn[lit.var()];
+                    variable_degree[t][lit.var()] += 1.0 / pow(2, clause->size());
                 }
             }
-        }
-
-        // ## Problem Size Features ##
-        record.push_back(n_clauses);
-        record.push_back(n_vars);
-        // DEL Ratio: C/V (including squared and cubic variants)
-        // DEL Reciprocal Ratio: V/C (including squared and cubic variants)
-        // DEL Linearized Ratio: |4.26 - C/V| (including squared and cubic variants)
+            if (!horn && !balance) return;
+
+            unsigned neg = count_negative(*clause);
+            if (horn) {
+                if (neg <= 1) {
+                    if (neg == 0) ++count.positive;
+                    ++count.horn;
+                    for (Lit lit : *clause) {
+                        ++variable_horn[t][lit.var()];
+                    }
+                }
+                if (clause->size() - neg <= 1) {
+                    if (clause->size() - neg == 0) ++count.negative;
+                    ++count.inv_horn;
+                    for (Lit lit : *clause) {
+                        ++variable_inv_horn[t][lit.var()];
+                    }
+                }
+            }
+            if (balance) {
+                float pos = clause->size() - neg;
+                count.pos_neg_per_clause.add(std::max<float>(pos, neg) > 0 ? std::min<float>(pos, neg) / std::max<float>(pos, neg) : 0);
+            }
+        });
 
-        // changed to absolute numbers, not fraction of unary, binary and ternary clauses, also added more
-        for (unsigned i = 1; i < 10; ++i) {
-            record.push_back(clause_sizes[i]);
+        Counts& total = counts[0];
+        for (unsigned t = 1; t < threads_; t++) {
+            for (unsigned i = 0; i < 10; ++i) {
+                total.clause_sizes[i] += counts[t].clause_sizes[i];
+            }
+            total.horn += counts[t].horn;
+            total.inv_horn += counts[t].inv_horn;
+            total.positive += counts[t].positive;
+            total.negative += counts[t].negative;
+            total.clause_occurrences.merge(counts[t].clause_occurrences);
+            total.pos_neg_per_clause.merge(counts[t].pos_neg_per_clause);
+        }
+        reduce_counters(&variable_horn, threads_);
+        reduce_counters(&variable_inv_horn, threads_);
+        reduce_counters(&variable_degree, threads_);
+        reduce_counters(&literal_occurrences, threads_);
+        literal_occurrences_.swap(literal_occurrences[0]);
+
+        std::vector<float> record;
+        if (sizes) {
+            // ## Problem Size Features ##
+            record.push_back(n_clauses);
+            record.push_back(n_vars);
+            // DEL Ratio: C/V (including squared and cubic variants)
+            // DEL Reciprocal Ratio: V/C (including squared and cubic variants)
+            // DEL Linearized Ratio: |4.26 - C/V| (including squared and cubic variants)
+
+            // changed to absolute numbers, not fraction of unary, binary and ternary clauses, also added more
+            for (unsigned i = 1; i < 10; ++i) {
+                record.push_back(total.clause_sizes[i]);
+            }
+            commit(SIZES, &record);
+        }
+        if (horn) {
+            // ## Horn, Pos, Neg Proximity ##
+            record.push_back(total.horn);
+            record.push_back(total.inv_horn);
+            record.push_back(total.positive);
+            record.push_back(total.negative);
+            push_statistics(&record, summarize(variable_horn[0]));
+            push_statistics(&record, summarize(variable_inv_horn[0]));
+            commit(HORN, &record);
+        }
+        if (vg) {
+            // ## Variable Graph Features ##
+            push_statistics(&record, summarize(variable_degree[0]));
+            commit(VG, &record);
+        }
+        if (balance) {
+            push_statistics(&record, total.pos_neg_per_clause);  // min over max
+            values_[BALANCE].swap(record);  // completed by analyze_variables()
+        }
+        if (vcg) {
+            push_statistics(&record, total.clause_occurrences);
+            values_[VCG].swap(record);  // completed by analyze_variables()
         }
-
-        // ## Horn, Pos, Neg Proximity ##
-        record.push_back(horn);
-        record.push_back(inv_horn);
-        record.push_back(positive);
-        record.push_back(negative);
-        push_distribution(&record, variable_horn);
-        push_distribution(&record, variable_inv_horn);
-
-        // ## Variable - Clause Graph Features ##
-        // Variable Node Degree Statistics:
-        push_distribution(&record, variable_occurrences);
-        // Clause Node Degree Statistics:
-        push_distribution(&record, clause_occurrences);
     }
 
-    void analyze_degrees() {
-        std::vector<unsigned> literal_occurrences;
-        literal_occurrences.resize(2 * formula_.nVars() + 2);
+    /**
+     * Per-variable statistics over literal occurrences for the groups balance and vcg
+     */
+    void analyze_variables() {
+        if (!selected(BALANCE) && !selected(VCG)) return;
+        begin_group(BALANCE, "Analyzing Variables");
+        if (selected(BALANCE)) {
+            std::vector<Distribution<float>> pos_neg_per_variable(threads_);  // one entry per variable
+            for_each_chunk(n_vars, [&] (unsigned t, size_t begin, size_t end) {
+                for (unsigned v = begin; v < end; v++) {
+                    // divide min by max (not pos by neg as in satzilla)
+                    float pos = static_cast<float>(literal_occurrences_[Lit(v, false)]);
+                    float neg = static_cast<float>(literal_occurrences_[Lit(v, true)]);
+                    pos_neg_per_variable[t].add(std::max(pos, neg) > 0 ? std::min(pos, neg) / std::max(pos, neg) : 0);
+                }
+            });
+            for (unsigned t = 1; t < threads_; t++) {
+                pos_neg_per_variable[0].merge(pos_neg_per_variable[t]);
+            }
+            std::vector<float> record;
+            record.swap(values_[BALANCE]);
+            push_statistics(&record, pos_neg_per_variable[0]);  // min over max
+            commit(BALANCE, &record);
+        }
 
-        // VG Node Distribution
-        std::vector<unsigned> variable_degree;  // one entry per variable (its degree in the VIG)
-        variable_degree.resize(n_vars + 1, 0);
+        if (selected(VCG)) {
+            // ## Variable - Clause Graph Features ##
+            std::vector<unsigned> variable_occurrences(n_vars + 1);  // one entry per variable (its num. of occurrences)
+            parallel_for(n_vars + 1, threads_, [&] (unsigned, size_t begin, size_t end) {
+                for (size_t v = begin; v < end; v++) {
+                    variable_occurrences[v] = literal_occurrences_[2 * v] + literal_occurrences_[2 * v + 1];
+                }
+            });
+            std::vector<float> record;
+            // Variable Node Degree Statistics:
+            push_statistics(&record, summarize(variable_occurrences));
+            // Clause Node Degree Statistics:
+            record.insert(record.end(), values_[VCG].begin(), values_[VCG].end());
+            commit(VCG, &record);
+        }
+    }
 
-        // min(pos, neg) / max(pos, neg) literal occurence per clause
-        std::vector<float> pos_neg_per_clause;  // one entry per clause
+    /**
+     * Power-law fit of the number of occurrences per variable (see PowerLaw.h)
+     */
+    void analyze_power_law() {
+        if (!selected(POWERLAW)) return;
+        begin_group(POWERLAW, "Power-Law Fit");
+        std::vector<uint64_t> histogram;
+        for (unsigned v = 1; v <= n_vars; v++) {
+            const unsigned occurrences = literal_occurrences_[2 * v] + literal_occurrences_[2 * v + 1];
+            if (occurrences >= histogram.size()) histogram.resize(occurrences + 1, 0);
+            ++histogram[occurrences];
+        }
+        PowerLaw fit(histogram);
+        fit.analyze();
+        std::vector<float> record;
+        record.push_back(fit.alpha);
+        record.push_back(fit.alpha_error);
+        record.push_back(fit.x_min);
+        record.push_back(n_vars > 0 ? static_cast<float>(fit.n_tail) / n_vars : 0);
+        record.push_back(fit.ks);
+        commit(POWERLAW, &record);
+    }
 
-        for (Cl* clause : formula_) {
-            float neg = 0;
+    /**
+     * Clause graph degrees (number of neighbour clauses), based on literal occurrences
+     */
+    void analyze_clause_graph() {
+        if (!selected(CG)) return;
+        begin_group(CG, "Clause Graph Features");
+        std::vector<Distribution<unsigned>> clause_degree(threads_);  // one entry per clause (number of neighbour clauses)
+        for_each_clause([&] (unsigned t, Cl* clause) {
+            unsigned degree = 0;
             for (Lit lit : *clause) {
-                ++literal_occurrences[lit];
-                variable_degree[lit.var()] += 1.0 / pow(2, clause->size());
-                if (lit.sign()) ++neg;
+                degree += literal_occurrences_[~lit];
             }
-            float pos = clause->size() - neg;
-            pos_neg_per_clause.push_back(std::max(pos, neg) > 0 ? std::min(pos, neg) / std::max(pos, neg) : 0);
+            clause_degree[t].add(degree);
+        });
+        for (unsigned t = 1; t < threads_; t++) {
+            clause_degree[0].merge(clause_degree[t]);
         }
-        // ## Variable Graph Features ##
-        push_distribution(&record, variable_degree);
-        variable_degree.clear();
-        std::vector<unsigned>().swap(variable_degree);
+        std::vector<float> record;
+        push_statistics(&record, clause_degree[0]);
+        commit(CG, &record);
+    }
 
-        push_distribution(&record, pos_neg_per_clause);  // min over max
-        pos_neg_per_clause.clear();
-        std::vector<float>().swap(pos_neg_per_clause);
+    /**
+     * Equivalent literals and implication depth of the binary implication graph (see ImplicationGraph.h)
+     */
+    void analyze_binary() {
+        if (!selected(BINARY)) return;
+        begin_group(BINARY, "Binary Implication Graph");
+        ImplicationGraph graph(formula_, limits_);
+        graph.analyze();
+        std::vector<float> record;
+        record.push_back(graph.unsat);
+        record.push_back(graph.classes);
+        record.push_back(graph.equivalent_literals);
+        record.push_back(graph.depth);
+        push_statistics(&record, graph.sizes);
+        commit(BINARY, &record);
+    }
 
-        limits_.within_limits_or_throw();
+    /**
+     * Triangles and clustering coefficients of the variable incidence graph (sampled for large graphs, see Clustering)
+     */
+    void analyze_clustering() {
+        if (!selected(CLUSTERING)) return;
+        begin_group(CLUSTERING, "Clustering Coefficients");
+        Clustering clustering(vig_, limits_, threads_);
+        clustering.analyze();
+        std::vector<float> record;
+        record.push_back(clustering.triangles);
+        record.push_back(clustering.triangles_error);
+        record.push_back(clustering.transitivity);
+        record.push_back(clustering.transitivity_error);
+        push_statistics(&record, clustering.coefficients);
+        commit(CLUSTERING, &record);
+    }
 
-        std::cout << "Pos/Neg per Variable" << std::endl;
-        std::vector<float> pos_neg_per_variable;  // one entry per variable
-        for (unsigned v = 0; v < n_vars; v++) {
-            // divide min by max (not pos by neg as in satzilla)
-            float pos = static_cast<float>(literal_occurrences[Lit(v, false)]);
-            float neg = static_cast<float>(literal_occurrences[Lit(v, true)]);
-            pos_neg_per_variable.push_back(std::max(pos, neg) > 0 ? std::min(pos, neg) / std::max(pos, neg) : 0);
-        }
-        push_distribution(&record, pos_neg_per_variable);  // min over max
-        pos_neg_per_variable.clear();
-        std::vector<float>().swap(pos_neg_per_variable);
+    /**
+     * Community structure of the weighted variable incidence graph (Louvain, see Communities.h)
+     */
+    void analyze_communities() {
+        if (!selected(COMMUNITY)) return;
+        begin_group(COMMUNITY, "Community Structure");
+        Louvain louvain(vig_, limits_, threads_);
+        louvain.analyze();
+        std::vector<float> record;
+        record.push_back(louvain.modularity);
+        record.push_back(louvain.communities);
+        record.push_back(louvain.levels);
+        push_statistics(&record, louvain.sizes);
+        commit(COMMUNITY, &record);
+    }
 
-        limits_.within_limits_or_throw();
+    /**
+     * Spectral radius and spectral gap of the variable incidence graph and of the variable clause graph (see Spectral.h)
+     */
+    void analyze_spectral() {
+        if (!selected(SPECTRAL)) return;
+        begin_group(SPECTRAL, "Spectral Features");
+        std::vector<float> record;
+        Spectral vig(vig_, limits_, threads_);
+        vig.analyze();
+        record.push_back(vig.spectral_radius);
+        record.push_back(vig.lambda_2);
+        record.push_back(1 - vig.lambda_2);
+        CSRGraph vcg_graph = CSRGraph::VariableClauseGraph(formula_, threads_, limits_);
+        Spectral vcg(vcg_graph, limits_, threads_);
+        vcg.analyze();
+        record.push_back(vcg.spectral_radius);
+        record.push_back(vcg.lambda_2);
+        record.push_back(1 - vcg.lambda_2);
+        commit(SPECTRAL, &record);
+    }
 
-        // ## Clause Graph Features ##
-        std::cout << "Clause Graph Features" << std::endl;
-        std::vector<unsigned> clause_degree;  // one entry per clause (number of neighbour clauses)
-        clause_degree.resize(n_clauses, 0);
-        unsigned cid = 0;
-        for (Cl* clause : formula_) {
-            clause_degree[cid] = 0;
-            for (Lit lit : *clause) {
-                clause_degree[cid] += literal_occurrences[~lit];
-            }
-            ++cid;
+    /**
+     * Treewidth upper bounds of the variable incidence graph by min-degree and min-fill elimination (see Treewidth.h)
+     */
+    void analyze_treewidth() {
+        if (!selected(TREEWIDTH)) return;
+        begin_group(TREEWIDTH, "Treewidth Upper Bounds");
+        Treewidth treewidth(vig_, limits_, threads_);
+        treewidth.analyze();
+        const unsigned upper_bound = std::min(treewidth.min_degree, treewidth.min_fill);
+        std::vector<float> record { static_cast<float>(treewidth.lower_bound), static_cast<float>(treewidth.min_degree), static_cast<float>(treewidth.min_fill),
+            static_cast<float>(upper_bound), static_cast<float>(upper_bound > Treewidth::max_width) };
+        commit(TREEWIDTH, &record);
+    }
+
+    /**
+     * Short probSAT runs with different seeds (see LocalSearch.h), averaged over the probes
+     */
+    void analyze_local_search() {
+        if (!selected(LOCALSEARCH)) return;
+        begin_group(LOCALSEARCH, "Local Search Probes");
+        LocalSearch search(formula_, limits_, threads_);
+        search.analyze();
+        double best_min = search.probes[0].best_unsat, best = 0, flip = 0, unsat = 0, autocorrelation = 0, solved = 0;
+        for (const LocalSearch::Probe& probe : search.probes) {
+            best_min = std::min<double>(best_min, probe.best_unsat);
+            best += probe.best_unsat;
+            flip += probe.best_flip;
+            unsat += probe.mean_unsat;
+            autocorrelation += probe.autocorrelation;
+            solved += probe.solved;
         }
-        push_distribution(&record, clause_degree);
+        const double n = search.probes.size();
+        std::vector<float> record { static_cast<float>(best_min), static_cast<float>(best / n), static_cast<float>(flip / n),
+            static_cast<float>(unsat / n), static_cast<float>(autocorrelation / n), static_cast<float>(solved / n) };
+        commit(LOCALSEARCH, &record);
     }
 
+    /**
+     * Bounded CDCL solves in four rounds (see CDCLProbe.h), all features but conflicts per second are reproducible
+     */
+    void analyze_cdcl() {
+        if (!selected(CDCL)) return;
+        begin_group(CDCL, "Search Space Probes");
+        CDCLProbe probe(formula_, limits_);
+        probe.analyze();
+        std::vector<float> record;
+        record.push_back(probe.status);
+        record.push_back(probe.conflicts);
+        record.push_back(probe.seconds > 0 ? probe.conflicts / probe.seconds : 0);
+        record.push_back(probe.conflicts > 0 ? static_cast<float>(probe.learned_short) / probe.conflicts : 0);
+        push_statistics(&record, probe.learned_sizes);
+        record.insert(record.end(), probe.fixed.begin(), probe.fixed.end());
+        commit(CDCL, &record);
+    }
+
+    /**
+     * Failed literal probing on the root level (see Propagation.h), followed by the runtime of the group
+     */
+    void analyze_propagation() {
+        if (!selected(PROPAGATION)) return;
+        begin_group(PROPAGATION, "Failed Literal Probing");
+        auto start = std::chrono::steady_clock::now();
+        Propagation propagation(formula_, limits_, threads_);
+        propagation.analyze();
+        std::vector<float> record;
+        record.push_back(propagation.root_conflict);
+        record.push_back(n_vars > 0 ? static_cast<float>(propagation.root_fixed) / n_vars : 0);
+        record.push_back(propagation.probed);
+        record.push_back(propagation.probed > 0 ? static_cast<float>(propagation.failed) / propagation.probed : 0);
+        push_statistics(&record, propagation.implications);
+        push_statistics(&record, propagation.depths);
+        record.push_back(static_cast<float>(std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count()));
+        commit(PROPAGATION, &record);
+    }
+
+    /**
+     * Each group is committed as soon as it is completed. If resource limits are exceeded,
+     * ResourceLimitsExceeded is thrown and BaseFeatures() still contains the completed groups
+     * (see StoppedAt()).
+     */
     void analyze() {
-        limits_.within_limits_or_throw();
-        std::cout << "Analyzing Occurrences" << std::endl;
-        analyze_occurrences();
-        limits_.within_limits_or_throw();
-        std::cout << "Analyzing Degrees" << std::endl;
-        analyze_degrees();
+        analyze_clauses();
+        analyze_variables();
+        analyze_clause_graph();
+        analyze_power_law();
+        std::vector<unsigned>().swap(literal_occurrences_);
+        analyze_binary();
+        if (needs(VIG)) {
+            begin_group(CLUSTERING, "Variable Incidence Graph");
+            vig_ = CSRGraph::VariableIncidenceGraph(formula_, threads_, limits_, selected(COMMUNITY));
+            analyze_clustering();
+            analyze_communities();
+            analyze_spectral();
+            analyze_treewidth();
+            vig_ = CSRGraph();
+        }
+        analyze_local_search();
+        analyze_cdcl();
+        analyze_propagation();
         std::cout << "Done" << std::endl;
 
-        // DEL Clustering Coefficient Statistics (FW: community structure features)
+        // ## Missing: LP-Based Features
 
-        // ## Missing: LP-Based Features, DPLL Search Space, Local Search Probes
+        runtime_ = static_cast<float>(limits_.get_runtime());
+    }
 
-        record.push_back(static_cast<float>(limits_.get_runtime()));
+    // Name of the group which was running when the limits were exceeded, i.e. the first selected group which is
+    // not completed from the running stage on (stages do not run in group order), empty if all are completed
+    std::string StoppedAt() const {
+        for (unsigned g = running_; g < N_GROUPS; g++) {
+            if (selected_[g] && !completed_[g]) return FeatureGroups()[g].name;
+        }
+        for (unsigned g = 0; g < running_; g++) {
+            if (selected_[g] && !completed_[g]) return FeatureGroups()[g].name;
+        }
+        return "";
     }
 
-    std::vector<float> BaseFeatures() {
+    // Features of the completed groups (in group order) followed by the runtime
+    std::vector<float> BaseFeatures() const {
+        std::vector<float> record;
+        for (unsigned g = 0; g < N_GROUPS; g++) if (completed_[g]) {
+            record.insert(record.end(), values_[g].begin(), values_[g].end());
+        }
+        record.push_back(runtime_);
         return record;
     }
 
+    // Names of BaseFeatures()
+    std::vector<std::string> FeatureNames() const {
+        std::vector<std::string> names;
+        for (unsigned g = 0; g < N_GROUPS; g++) if (completed_[g]) {
+            names.insert(names.end(), FeatureGroups()[g].features.begin(), FeatureGroups()[g].features.end());
+        }
+        names.push_back("base_features_runtime");
+        return names;
+    }
+
+    // Names of all features of the default groups
     static std::vector<std::string> BaseFeatureNames() {
-        return std::vector<std::string> { "clauses", "variables",
-            "clause_size_1", "clause_size_2", "clause_size_3", "clause_size_4", "clause_size_5", "clause_size_6", "clause_size_7", "clause_size_8", "clause_size_9",
-            "horn_clauses", "inv_horn_clauses", "positive_clauses", "negative_clauses",
-            "horn_vars_mean", "horn_vars_variance", "horn_vars_min", "horn_vars_max", "horn_vars_entropy",
-            "inv_horn_vars_mean", "inv_horn_vars_variance", "inv_horn_vars_min", "inv_horn_vars_max", "inv_horn_vars_entropy",
-            "vg_degrees_mean", "vg_degrees_variance", "vg_degrees_min", "vg_degrees_max", "vg_degrees_entropy",
-            "balance_clause_mean", "balance_clause_variance", "balance_clause_min", "balance_clause_max", "balance_clause_entropy",
-            "balance_vars_mean", "balance_vars_variance", "balance_vars_min", "balance_vars_max", "balance_vars_entropy",
-            "vcg_vdegrees_mean", "vcg_vdegrees_variance", "vcg_vdegrees_min", "vcg_vdegrees_max", "vcg_vdegrees_entropy",
-            "vcg_cdegrees_mean", "vcg_cdegrees_variance", "vcg_cdegrees_min", "vcg_cdegrees_max", "vcg_cdegrees_entropy",
-            "cg_degrees_mean", "cg_degrees_variance", "cg_degrees_min", "cg_degrees_max", "cg_degrees_entropy", "base_features_runtime"
-        };
+        std::vector<std::string> names;
+        for (const FeatureGroup& group : FeatureGroups()) if (group.default_on) {
+            names.insert(names.end(), group.features.begin(), group.features.end());
+        }
+        names.push_back("base_features_runtime");
+        return names;
     }
 };
 
@@ -0,0 +1,196 @@
+/*************************************************************************************************
+CNFTools -- Copyright (c) 2021, Markus Iser, KIT - Karlsruhe Institute of Technology
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT
+OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ **************************************************************************************************/
+
+#ifndef SRC_FEATURES_CLUSTERING_H_
+#define SRC_FEATURES_CLUSTERING_H_
+
+#include <math.h>
+
+#include <cstdint>
+#include <vector>
+#include <algorithm>
+
+#include "src/util/CSRGraph.h"
+#include "src/util/InvariantHash.h"
+#include "src/util/ResourceLimits.h"
+#include "src/util/ThreadPool.h"
+
+#include "src/features/Kernels.h"
+#include "src/features/Util.h"
+
+/**
+ * Triangles, transitivity (global clustering coefficient) and local clustering coefficients of an undirected graph.
+ * Triangles are counted exactly on the degree ordered graph (intersection of the forward neighbourhoods of
+ * both endpoints of each edge) if the estimated work is below exact_work. Larger graphs are sampled instead:
+ * transitivity is estimated from uniformly sampled wedges (paths of length two), and local coefficients of
+ * vertices with more than wedges_per_vertex wedges from as many sampled wedges each.
+ * Sampling is keyed by hashes of sample indices, such that results do not depend on the number of threads.
+ */
+class Clustering {
+    const CSRGraph& graph_;
+    const ResourceLimits& limits_;
+    unsigned threads_;
+
+    static inline double pairs(double degree) {
+        return degree * (degree - 1) / 2;
+    }
+
+    void count_triangles() {
+        CSRGraph forward = graph_.oriented(threads_, limits_);
+        std::vector<std::vector<unsigned>> per_vertex(threads_, std::vector<unsigned>(graph_.size(), 0));  // triangles
+        for_each_chunk(graph_.size(), threads_, limits_, [&] (unsigned t, size_t begin, size_t end) {
+            std::vector<unsigned>& count = per_vertex[t];
+            for (unsigned u = begin; u < end; u++) {
+                for (const unsigned* v = forward.begin(u); v != forward.end(u); ++v) {
+                    size_t common = intersect(forward.begin(u), forward.degree(u), forward.begin(*v), forward.degree(*v),
+                        [&count] (unsigned w) { ++count[w]; });
+                    count[u] += common;
+                    count[*v] += common;
+                }
+            }
+        }, 1 << 12);
+        reduce_counters(&per_vertex, threads_);
+
+        std::vector<Distribution<float>> local(threads_);
+        std::vector<uint64_t> sum(threads_, 0);
+        parallel_for(graph_.size(), threads_, [&] (unsigned t, size_t begin, size_t end) {
+            for (unsigned v = begin; v < end; v++) if (graph_.degree(v) > 1) {
+                sum[t] += per_vertex[0][v];
+                local[t].add(per_vertex[0][v] / pairs(graph_.degree(v)));
+            }
+        });
+        for (unsigned t = 0; t < threads_; t++) {
+            coefficients.merge(local[t]);
+            triangles += sum[t];
+        }
+        triangles /= 3;
+        transitivity = wedges > 0 ? 3 * triangles / wedges : 0;
+    }
+
+    void sample_wedges() {
+        // wedge centers are drawn proportional to their number of wedges
+        std::vector<double> cumulative(graph_.size());
+        double total = 0;
+        for (unsigned v = 0; v < graph_.size(); v++) {
+            total += pairs(graph_.degree(v));
+            cumulative[v] = total;
+        }
+        auto closed = [this] (unsigned v, uint64_t hash) {
+            const unsigned degree = graph_.degree(v);
+            unsigned i = (hash & 0xFFFFFFFF) % degree, j = (hash >> 32) % (degree - 1);
+            if (j >= i) ++j;
+            return graph_.adjacent(graph_.begin(v)[i], graph_.begin(v)[j]);
+        };
+
+        std::vector<uint64_t> hits(threads_, 0);
+        for_each_chunk(samples, threads_, limits_, [&] (unsigned t, size_t begin, size_t end) {
+            for (size_t s = begin; s < end; s++) {
+                double r = (mix64(s, 0xc1a5) >> 11) * 0x1.0p-53 * total;
+                unsigned v = std::upper_bound(cumulative.begin(), cumulative.end(), r) - cumulative.begin();
+                v = std::min<unsigned>(v, graph_.size() - 1);
+                if (closed(v, mix64(s, 0x3ed6))) ++hits[t];
+            }
+        }, 1 << 12);
+        uint64_t closed_wedges = 0;
+        for (uint64_t h : hits) closed_wedges += h;
+        transitivity = static_cast<double>(closed_wedges) / samples;
+        transitivity_error = sqrt(transitivity * (1 - transitivity) / samples);
+        triangles = transitivity * wedges / 3;
+        triangles_error = transitivity_error * wedges / 3;
+
+        std::vector<Distribution<float>> local(threads_);
+        for_each_chunk(graph_.size(), threads_, limits_, [&] (unsigned t, size_t begin, size_t end) {
+            for (unsigned v = begin; v < end; v++) if (graph_.degree(v) > 1) {
+                const unsigned degree = graph_.degree(v);
+                unsigned hit = 0, tried = 0;
+                if (pairs(degree) <= wedges_per_vertex) {
+                    for (const unsigned* a = graph_.begin(v); a != graph_.end(v); ++a) {
+                        for (const unsigned* b = a + 1; b != graph_.end(v); ++b) {
+                            hit += graph_.adjacent(*a, *b);
+                            ++tried;
+                        }
+                    }
+                } else {
+                    for (; tried < wedges_per_vertex; tried++) {
+                        hit += closed(v, mix64((uint64_t(v) << 32) | tried, 0x7e11));
+                    }
+                }
+                local[t].add(static_cast<float>(hit) / tried);
+            }
+        }, 1 << 12);
+        for (unsigned t = 0; t < threads_; t++) {
+            coefficients.merge(local[t]);
+        }
+    }
+
+ public:
+    static constexpr double exact_work = 1u << 31;  // compared elements for exact counting (bounds 32-bit triangle counters)
+    static constexpr unsigned wedges_per_vertex = 64;
+    static constexpr uint64_t samples = 1 << 20;  // sampled wedges for transitivity
+
+    bool exact = true;
+    double wedges = 0;  // number of paths of length two
+    double triangles = 0, triangles_error = 0;
+    double transitivity = 0, transitivity_error = 0;
+    Distribution<float> coefficients;  // local clustering coefficients of all vertices with degree > 1
+
+    Clustering(const CSRGraph& graph, const ResourceLimits& limits, unsigned threads = 1) :
+        graph_(graph), limits_(limits), threads_(ThreadPool::resolve(threads)) { }
+
+    /**
+     * Decides between counting and sampling by the work of exact counting (sum of the forward degrees
+     * of both endpoints over all edges)
+     * @throws ResourceLimitsExceeded
+     */
+    void analyze() {
+        auto forward = [this] (unsigned v, unsigned w) {
+            return graph_.degree(v) < graph_.degree(w) || (graph_.degree(v) == graph_.degree(w) && v < w);
+        };
+        std::vector<unsigned> forward_degree(graph_.size(), 0);
+        std::vector<double> work(threads_, 0), paths(threads_, 0);
+        for_each_chunk(graph_.size(), threads_, limits_, [&] (unsigned t, size_t begin, size_t end) {
+            for (unsigned v = begin; v < end; v++) {
+                paths[t] += pairs(graph_.degree(v));
+                for (const unsigned* w = graph_.begin(v); w != graph_.end(v); ++w) {
+                    forward_degree[v] += forward(v, *w);
+                }
+            }
+        });
+        for_each_chunk(graph_.size(), threads_, limits_, [&] (unsigned t, size_t begin, size_t end) {
+            for (unsigned v = begin; v < end; v++) {
+                for (const unsigned* w = graph_.begin(v); w != graph_.end(v); ++w) {
+                    if (forward(v, *w)) work[t] += forward_degree[v] + forward_degree[*w];
+                }
+            }
+        });
+        double total_work = 0;
+        for (unsigned t = 0; t < threads_; t++) {
+            wedges += paths[t];
+            total_work += work[t];
+        }
+        exact = total_work <= exact_work;
+        if (exact) {
+            count_triangles();
+        } else {
+            sample_wedges();
+        }
+    }
+};
+
+#endif  // SRC_FEATURES_CLUSTERING_H_
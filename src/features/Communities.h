@@ -0,0 +1,237 @@
+/*************************************************************************************************
+CNFTools -- Copyright (c) 2021, Markus Iser, KIT - Karlsruhe Institute of Technology
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT
+OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ **************************************************************************************************/
+
+#ifndef SRC_FEATURES_COMMUNITIES_H_
+#define SRC_FEATURES_COMMUNITIES_H_
+
+#include <cstdint>
+#include <vector>
+#include <algorithm>
+#include <numeric>
+
+#include "src/util/CSRGraph.h"
+#include "src/util/InvariantHash.h"
+#include "src/util/ResourceLimits.h"
+#include "src/util/ThreadPool.h"
+
+#include "src/features/Util.h"
+
+/**
+ * Community structure of a weighted graph by parallel Louvain modularity optimization.
+ * Each level moves vertices to the neighbour community of maximal modularity gain until the modularity
+ * does not improve any more, and then aggregates communities to the vertices of the next level.
+ * Moves are decided in parallel against the community state of the previous sub-round (vertices are split into
+ * sub-rounds by hash), a vertex of a singleton community only joins another singleton community of smaller label
+ * (prevents swaps), and a sweep which does not improve modularity is undone. Results do not depend on the number of threads.
+ */
+class Louvain {
+    const CSRGraph& graph_;
+    const ResourceLimits& limits_;
+    unsigned threads_;
+
+    static constexpr unsigned sub_rounds = 32;
+    static constexpr unsigned max_sweeps = 32;
+    static constexpr unsigned max_levels = 32;
+    static constexpr double min_improvement = 1e-6;
+
+    static inline float weight(const CSRGraph& graph, uint64_t i) {
+        return graph.weights.empty() ? 1.0f : graph.weights[i];
+    }
+
+    static double compute_modularity(const CSRGraph& graph, const std::vector<unsigned>& community, const std::vector<double>& total,
+            double total_weight, unsigned threads, const ResourceLimits& limits) {
+        std::vector<double> internal(ThreadPool::resolve(threads), 0);
+        for_each_chunk(graph.size(), threads, limits, [&] (unsigned t, size_t begin, size_t end) {
+            for (size_t v = begin; v < end; v++) {
+                for (uint64_t i = graph.offsets[v]; i < graph.offsets[v + 1]; i++) {
+                    if (community[graph.targets[i]] == community[v]) internal[t] += weight(graph, i);
+                }
+            }
+        });
+        double q = std::accumulate(internal.begin(), internal.end(), 0.0) / total_weight;
+        for (double tot : total) {
+            q -= (tot / total_weight) * (tot / total_weight);
+        }
+        return q;
+    }
+
+    /**
+     * Local moving on one level, returns the communities renumbered to [0, k)
+     */
+    std::vector<unsigned> move(const CSRGraph& graph, double* q) {
+        const size_t n = graph.size();
+        std::vector<double> degree(n, 0);  // weighted, self loops included
+        parallel_for(n, threads_, [&] (unsigned, size_t begin, size_t end) {
+            for (size_t v = begin; v < end; v++) {
+                for (uint64_t i = graph.offsets[v]; i < graph.offsets[v + 1]; i++) degree[v] += weight(graph, i);
+            }
+        });
+        const double total_weight = std::accumulate(degree.begin(), degree.end(), 0.0);  // 2m
+        std::vector<unsigned> community(n);
+        std::iota(community.begin(), community.end(), 0);
+        std::vector<double> total(degree);  // weighted degree of each community
+        std::vector<unsigned> size(n, 1);
+        *q = total_weight > 0 ? compute_modularity(graph, community, total, total_weight, threads_, limits_) : 0;
+        if (total_weight == 0) return community;
+
+        // vertices (with edges) by sub-round
+        std::vector<uint64_t> round_offsets(sub_rounds + 1, 0);
+        for (size_t v = 0; v < n; v++) if (degree[v] > 0) ++round_offsets[mix64(v) % sub_rounds + 1];
+        for (unsigned round = 0; round < sub_rounds; round++) round_offsets[round + 1] += round_offsets[round];
+        std::vector<unsigned> vertices(round_offsets[sub_rounds]);
+        std::vector<uint64_t> fill(round_offsets.begin(), round_offsets.end() - 1);
+        for (size_t v = 0; v < n; v++) if (degree[v] > 0) vertices[fill[mix64(v) % sub_rounds]++] = v;
+
+        std::vector<unsigned> target(vertices.size());
+        std::vector<std::vector<double>> links(threads_);  // weight from the current vertex to each community
+        std::vector<std::vector<unsigned>> touched(threads_);
+        for (unsigned sweep = 0; sweep < max_sweeps; sweep++) {
+            const std::vector<unsigned> previous(community);
+            for (unsigned round = 0; round < sub_rounds; round++) {
+                const uint64_t first = round_offsets[round], last = round_offsets[round + 1];
+                for_each_chunk(last - first, threads_, limits_, [&] (unsigned t, size_t begin, size_t end) {
+                    std::vector<double>& link = links[t];
+                    if (link.empty()) link.resize(n, 0);
+                    for (uint64_t k = first + begin; k < first + end; k++) {
+                        const unsigned v = vertices[k];
+                        target[k] = community[v];
+                        const unsigned own = community[v];
+                        link[own] = 0;
+                        touched[t].assign(1, own);
+                        for (uint64_t i = graph.offsets[v]; i < graph.offsets[v + 1]; i++) {
+                            const unsigned w = graph.targets[i];
+                            if (w == v) continue;
+                            const unsigned c = community[w];
+                            if (link[c] == 0 && c != own) touched[t].push_back(c);
+                            link[c] += weight(graph, i);
+                        }
+                        // gain of joining c (after leaving own): link[c] - degree[v] * total[c] / 2m
+                        double best_gain = link[own] - degree[v] * (total[own] - degree[v]) / total_weight;
+                        unsigned best = own;
+                        for (unsigned c : touched[t]) {
+                            if (c == own) continue;
+                            double gain = link[c] - degree[v] * total[c] / total_weight;
+                            if (gain > best_gain || (gain == best_gain && best != own && c < best)) {
+                                best_gain = gain;
+                                best = c;
+                            }
+                        }
+                        for (unsigned c : touched[t]) link[c] = 0;
+                        if (best != own && size[own] == 1 && size[best] == 1 && best > own) continue;
+                        target[k] = best;
+                    }
+                }, 1 << 12);
+                for (uint64_t k = first; k < last; k++) {
+                    const unsigned v = vertices[k];
+                    if (target[k] == community[v]) continue;
+                    total[community[v]] -= degree[v];
+                    --size[community[v]];
+                    community[v] = target[k];
+                    total[community[v]] += degree[v];
+                    ++size[community[v]];
+                }
+            }
+            const double updated = compute_modularity(graph, community, total, total_weight, threads_, limits_);
+            if (updated < *q) {  // undo the sweep
+                community = previous;
+                break;
+            }
+            const double improvement = updated - *q;
+            *q = updated;
+            if (improvement < min_improvement) break;
+        }
+
+        std::vector<unsigned> label(n, n);
+        unsigned k = 0;
+        for (size_t v = 0; v < n; v++) {
+            if (label[community[v]] == n) label[community[v]] = k++;
+            community[v] = label[community[v]];
+        }
+        return community;
+    }
+
+    /**
+     * Graph of communities: vertex c has a self loop with the weight of the edges within c (counted from both sides)
+     */
+    CSRGraph aggregate(const CSRGraph& graph, const std::vector<unsigned>& community, unsigned k) {
+        std::vector<uint64_t> member_offsets(k + 1, 0);
+        for (unsigned c : community) ++member_offsets[c + 1];
+        for (unsigned c = 0; c < k; c++) member_offsets[c + 1] += member_offsets[c];
+        std::vector<unsigned> members(graph.size());
+        std::vector<uint64_t> fill(member_offsets.begin(), member_offsets.end() - 1);
+        for (size_t v = 0; v < graph.size(); v++) members[fill[community[v]]++] = v;
+
+        CSRGraph coarse = CSRGraph::build(k, threads_, limits_, [&] (unsigned, size_t c, std::vector<unsigned>* row) {
+            for (uint64_t m = member_offsets[c]; m < member_offsets[c + 1]; m++) {
+                for (const unsigned* w = graph.begin(members[m]); w != graph.end(members[m]); ++w) {
+                    row->push_back(community[*w]);
+                }
+            }
+        });
+        coarse.set_weights(threads_, limits_, [&] (unsigned, size_t c, auto add) {
+            for (uint64_t m = member_offsets[c]; m < member_offsets[c + 1]; m++) {
+                const unsigned v = members[m];
+                for (uint64_t i = graph.offsets[v]; i < graph.offsets[v + 1]; i++) {
+                    add(community[graph.targets[i]], weight(graph, i));
+                }
+            }
+        });
+        return coarse;
+    }
+
+ public:
+    double modularity = 0;
+    unsigned communities = 0;  // communities with at least one edge
+    unsigned levels = 0;
+    Distribution<unsigned> sizes;  // number of vertices per community (with at least one edge)
+
+    Louvain(const CSRGraph& graph, const ResourceLimits& limits, unsigned threads = 1) :
+        graph_(graph), limits_(limits), threads_(ThreadPool::resolve(threads)) { }
+
+    /**
+     * @throws ResourceLimitsExceeded
+     */
+    void analyze() {
+        std::vector<unsigned> membership(graph_.size());  // community of each vertex of the input graph
+        std::iota(membership.begin(), membership.end(), 0);
+        CSRGraph coarse;
+        const CSRGraph* graph = &graph_;
+        for (levels = 0; levels < max_levels; ) {
+            std::vector<unsigned> community = move(*graph, &modularity);
+            const unsigned k = community.empty() ? 0 : *std::max_element(community.begin(), community.end()) + 1;
+            if (k == graph->size()) break;
+            ++levels;
+            for (unsigned& c : membership) c = community[c];
+            coarse = aggregate(*graph, community, k);
+            graph = &coarse;
+            limits_.within_limits_or_throw();
+        }
+
+        std::vector<unsigned> count(graph->size(), 0);
+        for (size_t v = 0; v < graph_.size(); v++) {
+            if (graph_.degree(v) > 0) ++count[membership[v]];
+        }
+        for (unsigned c : count) if (c > 0) {
+            sizes.add(c);
+            ++communities;
+        }
+    }
+};
+
+#endif  // SRC_FEATURES_COMMUNITIES_H_
@@ -28,6 +28,7 @@ OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWA
 #include <string>
 
 #include "src/util/SolverTypes.h"
+#include "src/util/InvariantHash.h"
 #include "src/util/ResourceLimits.h"
 
 #include "src/gates/GateFormula.h"
@@ -40,6 +41,90 @@ class GateStats {
     const ResourceLimits& limits_;
     std::vector<float> record;
     std::set<unsigned int> gate_list; 
+
+    /**
+     * Shape of the gate DAG (edges from gate outputs to their input variables) in one topological sweep from the inputs
+     * to the outputs (Kahn's algorithm on the consumer lists): fan-out of gate outputs, width profile over levels
+     * (level = longest path from the inputs), depth, and reconvergent fan-out. Up to 64 fan-out stems (variables with
+     * fan-out >= 2, chosen by hash) get one bit each, which is propagated to all consumers; a stem reconverges if its
+     * bit arrives at some gate from two different inputs.
+     */
+    void analyze_structure(const GateFormula& gates) {
+        const unsigned n = gates.nVars();
+        // input variables of each gate (inputs of non-monotonic gates contain both literals of a variable)
+        std::vector<uint64_t> input_offsets(n + 1, 0);
+        std::vector<unsigned> inputs, fanout(n, 0), pending(n, 0);  // pending: inputs which are gate outputs and not yet swept
+        std::vector<unsigned> stamp(n, 0);
+        for (unsigned v = 0; v < n; v++) {
+            if (gates[Var(v)].isDefined()) {
+                for (Lit lit : gates[Var(v)].inp) {
+                    const unsigned x = lit.var();
+                    if (stamp[x] == v + 1) continue;
+                    stamp[x] = v + 1;
+                    inputs.push_back(x);
+                    ++fanout[x];
+                    if (gates[Var(x)].isDefined()) ++pending[v];
+                }
+            }
+            input_offsets[v + 1] = inputs.size();
+        }
+        std::vector<uint64_t> offsets(n + 1, 0);  // consumers of each variable
+        for (unsigned v = 0; v < n; v++) {
+            offsets[v + 1] = offsets[v] + fanout[v];
+        }
+        std::vector<unsigned> consumers(offsets[n]);
+        std::vector<uint64_t> fill(offsets.begin(), offsets.end() - 1);
+        for (unsigned v = 0; v < n; v++) {
+            for (uint64_t i = input_offsets[v]; i < input_offsets[v + 1]; i++) consumers[fill[inputs[i]]++] = v;
+        }
+
+        std::vector<unsigned> stems;
+        for (unsigned v = 0; v < n; v++) {
+            if (fanout[v] >= 2) stems.push_back(v);
+        }
+        const unsigned n_stems = stems.size();
+        auto by_hash = [] (unsigned a, unsigned b) { return mix64(a) < mix64(b) || (mix64(a) == mix64(b) && a < b); };
+        if (stems.size() > 64) {
+            std::nth_element(stems.begin(), stems.begin() + 64, stems.end(), by_hash);
+            stems.resize(64);
+        }
+        std::vector<uint64_t> tags(n, 0);
+        for (unsigned i = 0; i < stems.size(); i++) {
+            tags[stems[i]] = uint64_t(1) << i;
+        }
+
+        Distribution<unsigned> fanouts;
+        std::vector<unsigned> height(n, 0), queue, widths;
+        for (unsigned v = 0; v < n; v++) {
+            if (!gates[Var(v)].isDefined()) continue;
+            fanouts.add(fanout[v]);
+            if (pending[v] == 0) queue.push_back(v);
+        }
+        uint64_t reconvergent = 0;
+        for (size_t head = 0; head < queue.size(); head++) {
+            const unsigned v = queue[head];
+            uint64_t seen = 0;
+            height[v] = 1;  // gates without inputs (constants) are on the first level
+            for (uint64_t i = input_offsets[v]; i < input_offsets[v + 1]; i++) {
+                height[v] = std::max(height[v], height[inputs[i]] + 1);
+                reconvergent |= seen & tags[inputs[i]];
+                seen |= tags[inputs[i]];
+            }
+            tags[v] |= seen;
+            if (height[v] > widths.size()) widths.resize(height[v], 0);
+            ++widths[height[v] - 1];
+            for (uint64_t i = offsets[v]; i < offsets[v + 1]; i++) {
+                if (--pending[consumers[i]] == 0) queue.push_back(consumers[i]);
+            }
+        }
+
+        push_distribution(&record, fanouts);
+        push_distribution(&record, widths);
+        record.push_back(widths.size());
+        record.push_back(n_stems);
+        record.push_back(stems.empty() ? 0 : static_cast<float>(__builtin_popcountll(reconvergent)) / stems.size());
+    }
+
  public:
     unsigned n_vars, n_gates, n_roots;
     unsigned n_none, n_generic, n_mono, n_and, n_or, n_triv, n_equiv, n_full;
@@ -49,13 +134,14 @@ class GateStats {
      n_none(0), n_generic(0), n_mono(0), n_and(0), n_or(0), n_triv(0), n_equiv(0), n_full(0) { }
 
     void analyze(unsigned repeat, unsigned verbose) {
-        std::vector<unsigned> levels, levels_none, levels_generic, levels_mono, levels_and, levels_or, levels_triv, levels_equiv, levels_full;
+        std::vector<unsigned> levels;
+        Distribution<unsigned> levels_none, levels_generic, levels_mono, levels_and, levels_or, levels_triv, levels_equiv, levels_full;
         GateAnalyzer<> analyzer(formula_, limits_, true, true, repeat, verbose);
         analyzer.analyze();
-        GateFormula gates = analyzer.getGateFormula();
+        const GateFormula& gates = analyzer.getGateFormula();
         n_gates = gates.nGates();
         n_roots = gates.nRoots();
-        levels.resize(n_vars, 0);
+        levels.resize(n_vars + 1, 0);
         // BFS for level determination
         unsigned level = 0;
         std::vector<Lit> current = gates.getRoots();
@@ -63,7 +149,7 @@ class GateStats {
         while (!current.empty()) {
             ++level;
             for (Lit lit : current) {
-                const Gate& gate = gates.getGate(lit);
+                const Gate& gate = gates[lit.var()];
                 if (gate.isDefined() && levels[lit.var()] == 0) {
                     levels[lit.var()] = level;
                     next.insert(next.end(), gate.inp.begin(), gate.inp.end());
@@ -74,46 +160,46 @@ class GateStats {
         }
         // Gate Type Counts and Levels
         for (unsigned i = 1; i <= n_vars; i++) {
-            const Gate& gate = gates.getGate(Lit(Var(i)));
+            const Gate& gate = gates[Var(i)];
             switch (gate.type) {
                 case NONE:  // input variable
                     ++n_none;
-                    levels_none.push_back(levels[i]);
+                    levels_none.add(levels[i]);
                     break;
                 case GENERIC:  // generically recognized gate
                     ++n_generic;
                     gate_list.insert(i);
-                    levels_generic.push_back(levels[i]);
+                    levels_generic.add(levels[i]);
                     break;
                 case MONO:  // monotonically nested gate
                     ++n_mono;
                     gate_list.insert(i);
-                    levels_mono.push_back(levels[i]);
+                    levels_mono.add(levels[i]);
                     break;
                 case AND:  // non-monotonically nested and-gate
                     ++n_and;
                     gate_list.insert(i);
-                    levels_and.push_back(levels[i]);
+                    levels_and.add(levels[i]);
                     break;
                 case OR:  // non-monotonically nested or-gate
                     ++n_or;
                     gate_list.insert(i);
-                    levels_or.push_back(levels[i]);
+                    levels_or.add(levels[i]);
                     break;
                 case TRIV:  // non-monotonically nested trivial equivalence gate
                     ++n_triv;
                     gate_list.insert(i);
-                    levels_triv.push_back(levels[i]);
+                    levels_triv.add(levels[i]);
                     break;
                 case EQIV:  // non-monotonically nested equiv- or xor-gate
                     ++n_equiv;
                     gate_list.insert(i);
-                    levels_equiv.push_back(levels[i]);
+                    levels_equiv.add(levels[i]);
                     break;
                 case FULL:  // non-monotonically nested full gate (=maxterm encoding) with more than two inputs
                     ++n_full;
                     gate_list.insert(i);
-                    levels_full.push_back(levels[i]);
+                    levels_full.add(levels[i]);
                     break;
             }
         }
@@ -138,6 +224,7 @@ class GateStats {
         push_distribution(&record, levels_triv);
         push_distribution(&record, levels_equiv);
         push_distribution(&record, levels_full);
+        analyze_structure(gates);
         record.push_back(static_cast<float>(limits_.get_runtime()));
     }
 
@@ -161,7 +248,10 @@ class GateStats {
             "levels_or_mean", "levels_or_variance", "levels_or_min", "levels_or_max", "levels_or_entropy",
             "levels_triv_mean", "levels_triv_variance", "levels_triv_min", "levels_triv_max", "levels_triv_entropy",
             "levels_equiv_mean", "levels_equiv_variance", "levels_equiv_min", "levels_equiv_max", "levels_equiv_entropy",
-            "levels_full_mean", "levels_full_variance", "levels_full_min", "levels_full_max", "levels_full_entropy", "gate_features_runtime"
+            "levels_full_mean", "levels_full_variance", "levels_full_min", "levels_full_max", "levels_full_entropy",
+            "gate_fanout_mean", "gate_fanout_variance", "gate_fanout_min", "gate_fanout_max", "gate_fanout_entropy",
+            "gate_width_mean", "gate_width_variance", "gate_width_min", "gate_width_max", "gate_width_entropy",
+            "gate_depth", "gate_stems", "gate_reconvergent", "gate_features_runtime"
         };
     }
 };
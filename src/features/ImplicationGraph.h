@@ -0,0 +1,152 @@
+/*************************************************************************************************
+CNFTools -- Copyright (c) 2021, Markus Iser, KIT - Karlsruhe Institute of Technology
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT
+OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ **************************************************************************************************/
+
+#ifndef SRC_FEATURES_IMPLICATIONGRAPH_H_
+#define SRC_FEATURES_IMPLICATIONGRAPH_H_
+
+#include <cstdint>
+#include <vector>
+#include <algorithm>
+
+#include "src/util/SolverTypes.h"
+#include "src/util/CNFFormula.h"
+#include "src/util/ResourceLimits.h"
+
+#include "src/features/Util.h"
+
+/**
+ * Strongly connected components of the binary implication graph: each binary clause (a | b) gives the edges
+ * -a -> b and -b -> a, each unit clause (u) the edge -u -> u. Literals in one component are equivalent, and the
+ * 2-SAT part of the formula is unsatisfiable iff some literal and its negation share a component.
+ * Edges are stored in CSR format over literal codes and components are found by Tarjan's algorithm with an explicit
+ * stack, so time and memory are linear in the number of literals and binary clauses.
+ * Tarjan completes components in reverse topological order, such that the longest path in the condensation
+ * (implication depth) is obtained on the fly from the depths of the successor components.
+ */
+class ImplicationGraph {
+    const ResourceLimits& limits_;
+    size_t n_lits_;
+    std::vector<uint64_t> offsets_;
+    std::vector<uint32_t> edges_;
+
+    static constexpr uint32_t none = UINT32_MAX;
+
+ public:
+    bool unsat = false;  // some literal is equivalent to its negation
+    unsigned classes = 0;  // non-trivial equivalence classes (a class and its negation are counted once)
+    unsigned equivalent_literals = 0;  // sum of class sizes minus one (variables which could be substituted)
+    unsigned depth = 0;  // longest path of implications between components
+    Distribution<unsigned> sizes;  // sizes of the non-trivial classes
+
+    ImplicationGraph(const CNFFormula& formula, const ResourceLimits& limits) :
+     limits_(limits), n_lits_(2 * (formula.nVars() + 1)) {
+        offsets_.assign(n_lits_ + 1, 0);
+        for (const Cl* clause : formula) {
+            if (clause->size() == 1) {
+                ++offsets_[((*clause)[0].x ^ 1) + 1];
+            } else if (clause->size() == 2) {
+                ++offsets_[((*clause)[0].x ^ 1) + 1];
+                ++offsets_[((*clause)[1].x ^ 1) + 1];
+            }
+        }
+        for (size_t l = 0; l < n_lits_; l++) {
+            offsets_[l + 1] += offsets_[l];
+        }
+        edges_.resize(offsets_[n_lits_]);
+        std::vector<uint64_t> fill(offsets_.begin(), offsets_.end() - 1);
+        for (const Cl* clause : formula) {
+            if (clause->size() == 1) {
+                edges_[fill[(*clause)[0].x ^ 1]++] = (*clause)[0].x;
+            } else if (clause->size() == 2) {
+                edges_[fill[(*clause)[0].x ^ 1]++] = (*clause)[1].x;
+                edges_[fill[(*clause)[1].x ^ 1]++] = (*clause)[0].x;
+            }
+        }
+    }
+
+    /**
+     * @throws ResourceLimitsExceeded
+     */
+    void analyze() {
+        std::vector<uint32_t> index(n_lits_, none), low(n_lits_), component(n_lits_, none);
+        std::vector<uint32_t> stack;  // Tarjan's stack of visited literals without component
+        std::vector<std::pair<uint32_t, uint64_t>> calls;  // DFS stack of literal and next edge
+        std::vector<uint32_t> component_depth, component_size, representative;
+        uint32_t next_index = 0;
+        uint64_t steps = 0;
+
+        for (uint32_t root = 0; root < n_lits_; root++) {
+            if (index[root] != none || offsets_[root] == offsets_[root + 1]) continue;
+            index[root] = low[root] = next_index++;
+            stack.push_back(root);
+            calls.emplace_back(root, offsets_[root]);
+            while (!calls.empty()) {
+                if ((++steps & 0xFFFF) == 0) limits_.within_limits_or_throw();
+                const uint32_t v = calls.back().first;
+                uint64_t& edge = calls.back().second;
+                if (edge < offsets_[v + 1]) {
+                    const uint32_t w = edges_[edge++];
+                    if (index[w] == none) {
+                        index[w] = low[w] = next_index++;
+                        stack.push_back(w);
+                        calls.emplace_back(w, offsets_[w]);
+                    } else if (component[w] == none) {
+                        low[v] = std::min(low[v], index[w]);
+                    }
+                    continue;
+                }
+                calls.pop_back();
+                if (!calls.empty()) {
+                    const uint32_t parent = calls.back().first;
+                    low[parent] = std::min(low[parent], low[v]);
+                }
+                if (low[v] != index[v]) continue;
+                // v is the root of a component, which consists of v and the literals above it on the stack
+                const uint32_t c = component_size.size();
+                size_t begin = stack.size();
+                do {
+                    component[stack[--begin]] = c;
+                } while (stack[begin] != v);
+                uint32_t d = 0;  // all successors outside the component are completed
+                for (size_t i = begin; i < stack.size(); i++) {
+                    for (uint64_t e = offsets_[stack[i]]; e < offsets_[stack[i] + 1]; e++) {
+                        if (component[edges_[e]] != c) d = std::max(d, component_depth[component[edges_[e]]] + 1);
+                    }
+                }
+                component_size.push_back(stack.size() - begin);
+                component_depth.push_back(d);
+                representative.push_back(v);
+                depth = std::max(depth, d);
+                stack.resize(begin);
+            }
+        }
+
+        for (uint32_t c = 0; c < component_size.size(); c++) {
+            const uint32_t dual = component[representative[c] ^ 1];
+            if (dual == c) unsat = true;
+            if (component_size[c] > 1 && c <= dual) {
+                ++classes;
+                equivalent_literals += component_size[c] - 1;
+                sizes.add(component_size[c]);
+            }
+        }
+    }
+};
+
+#endif  // SRC_FEATURES_IMPLICATIONGRAPH_H_
@@ -0,0 +1,223 @@
+/*************************************************************************************************
+CNFTools -- Copyright (c) 2021, Markus Iser, KIT - Karlsruhe Institute of Technology
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT
+OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ **************************************************************************************************/
+
+#ifndef SRC_FEATURES_KERNELS_H_
+#define SRC_FEATURES_KERNELS_H_
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+#include <algorithm>
+
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+#include "src/util/SolverTypes.h"
+
+/**
+ * Counting and reduction kernels for feature extraction over flat arrays of literals and counters.
+ * AVX2 code paths are selected at compile time (-mavx2, see the cmake option CNFTOOLS_AVX2), otherwise scalar loops are used.
+ */
+
+static_assert(sizeof(Lit) == sizeof(uint32_t), "kernels read literals as 32-bit words");
+
+/**
+ * Number of negative literals in the given clause (sign bits are the lowest bit of each literal)
+ */
+inline unsigned count_negative(const Cl& clause) {
+    const uint32_t* lits = reinterpret_cast<const uint32_t*>(clause.data());
+    size_t n = clause.size(), i = 0;
+    unsigned neg = 0;
+#ifdef __AVX2__
+    if (n >= 8) {
+        const __m256i one = _mm256_set1_epi32(1);
+        __m256i acc = _mm256_setzero_si256();
+        for (const size_t end = n - n % 8; i < end; i += 8) {
+            __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(lits + i));
+            acc = _mm256_add_epi32(acc, _mm256_and_si256(x, one));
+        }
+        __m128i s = _mm_add_epi32(_mm256_castsi256_si128(acc), _mm256_extracti128_si256(acc, 1));
+        s = _mm_hadd_epi32(s, s);
+        s = _mm_hadd_epi32(s, s);
+        neg = _mm_cvtsi128_si32(s);
+    }
+#endif
+    for (; i < n; i++) {
+        neg += lits[i] & 1;
+    }
+    return neg;
+}
+
+struct MinMaxSum {
+    uint32_t min, max;
+    uint64_t sum;
+};
+
+/**
+ * Minimum, maximum and exact 64-bit sum of n > 0 counters
+ */
+inline MinMaxSum min_max_sum(const uint32_t* data, size_t n) {
+    uint32_t min = data[0], max = data[0];
+    uint64_t sum = 0;
+    size_t i = 0;
+#ifdef __AVX2__
+    if (n >= 8) {
+        __m256i lo = _mm256_set1_epi32(data[0]);
+        __m256i hi = lo;
+        __m256i acc = _mm256_setzero_si256();
+        for (const size_t end = n - n % 8; i < end; i += 8) {
+            __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+            lo = _mm256_min_epu32(lo, x);
+            hi = _mm256_max_epu32(hi, x);
+            acc = _mm256_add_epi64(acc, _mm256_cvtepu32_epi64(_mm256_castsi256_si128(x)));
+            acc = _mm256_add_epi64(acc, _mm256_cvtepu32_epi64(_mm256_extracti128_si256(x, 1)));
+        }
+        alignas(32) uint32_t lanes_lo[8], lanes_hi[8];
+        alignas(32) uint64_t lanes_sum[4];
+        _mm256_store_si256(reinterpret_cast<__m256i*>(lanes_lo), lo);
+        _mm256_store_si256(reinterpret_cast<__m256i*>(lanes_hi), hi);
+        _mm256_store_si256(reinterpret_cast<__m256i*>(lanes_sum), acc);
+        min = *std::min_element(lanes_lo, lanes_lo + 8);
+        max = *std::max_element(lanes_hi, lanes_hi + 8);
+        sum = lanes_sum[0] + lanes_sum[1] + lanes_sum[2] + lanes_sum[3];
+    }
+#endif
+    for (; i < n; i++) {
+        if (data[i] < min) min = data[i];
+        if (data[i] > max) max = data[i];
+        sum += data[i];
+    }
+    return MinMaxSum { min, max, sum };
+}
+
+/**
+ * Sum of squared deviations of n counters from the given mean (second pass of the two-pass variance)
+ */
+inline double squared_deviation(const uint32_t* data, size_t n, double mean) {
+    double result = 0;
+    size_t i = 0;
+#ifdef __AVX2__
+    if (n >= 4) {
+        // unsigned to double: flip the sign bit, convert as signed and add 2^31
+        const __m128i flip = _mm_set1_epi32(INT32_MIN);
+        const __m256d offset = _mm256_set1_pd(2147483648.0 - mean);
+        __m256d acc = _mm256_setzero_pd();
+        for (const size_t end = n - n % 4; i < end; i += 4) {
+            __m128i x = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i)), flip);
+            __m256d d = _mm256_add_pd(_mm256_cvtepi32_pd(x), offset);
+            acc = _mm256_add_pd(acc, _mm256_mul_pd(d, d));
+        }
+        alignas(32) double lanes[4];
+        _mm256_store_pd(lanes, acc);
+        result = (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+    }
+#endif
+    for (; i < n; i++) {
+        double d = data[i] - mean;
+        result += d * d;
+    }
+    return result;
+}
+
+/**
+ * Frequency histogram of n counters with values in [0, max], added to the given frequency vector.
+ * Consecutive samples are counted in separate sub-histograms, such that repeated increments
+ * of the same bin do not wait for each other (store-to-load forwarding), as long as the
+ * sub-histograms fit in cache. Larger ranges are counted directly.
+ */
+inline void count_frequencies(const uint32_t* data, size_t n, uint32_t max, std::vector<uint64_t>* frequency) {
+    constexpr unsigned ways = 4;
+    constexpr size_t max_bins = 1 << 16;
+    const size_t n_bins = size_t(max) + 1;
+    if (frequency->size() < n_bins) {
+        frequency->resize(n_bins, 0);
+    }
+    if (n_bins > max_bins || n < ways * n_bins) {
+        for (size_t i = 0; i < n; i++) {
+            ++(*frequency)[data[i]];
+        }
+        return;
+    }
+    std::vector<uint32_t> bins(ways * n_bins, 0);
+    uint32_t* sub[ways];
+    for (unsigned w = 0; w < ways; w++) {
+        sub[w] = bins.data() + w * n_bins;
+    }
+    size_t i = 0;
+    for (const size_t end = n - n % ways; i < end; i += ways) {
+        for (unsigned w = 0; w < ways; w++) {
+            ++sub[w][data[i + w]];
+        }
+    }
+    for (; i < n; i++) {
+        ++(*frequency)[data[i]];
+    }
+    for (size_t b = 0; b < n_bins; b++) {
+        for (unsigned w = 0; w < ways; w++) {
+            (*frequency)[b] += sub[w][b];
+        }
+    }
+}
+
+/**
+ * Intersection of two sorted arrays of distinct values: calls f(x) for each common value x and returns their number.
+ * With AVX2, blocks of eight values of a are compared against all rotations of blocks of eight values of b,
+ * and the block with the smaller maximum is advanced.
+ */
+template <typename Function>
+inline size_t intersect(const uint32_t* a, size_t na, const uint32_t* b, size_t nb, Function f) {
+    size_t i = 0, j = 0, count = 0;
+#ifdef __AVX2__
+    if (na >= 8 && nb >= 8) {
+        const __m256i rotate = _mm256_set_epi32(0, 7, 6, 5, 4, 3, 2, 1);
+        for (const size_t end_a = na - na % 8, end_b = nb - nb % 8; i < end_a && j < end_b; ) {
+            __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i));
+            __m256i y = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + j));
+            __m256i match = _mm256_cmpeq_epi32(x, y);
+            for (unsigned r = 1; r < 8; r++) {
+                y = _mm256_permutevar8x32_epi32(y, rotate);
+                match = _mm256_or_si256(match, _mm256_cmpeq_epi32(x, y));
+            }
+            for (unsigned mask = _mm256_movemask_ps(_mm256_castsi256_ps(match)); mask != 0; mask &= mask - 1) {
+                f(a[i + __builtin_ctz(mask)]);
+                ++count;
+            }
+            const uint32_t max_a = a[i + 7], max_b = b[j + 7];
+            if (max_a <= max_b) i += 8;
+            if (max_b <= max_a) j += 8;
+        }
+    }
+#endif
+    while (i < na && j < nb) {
+        if (a[i] < b[j]) {
+            ++i;
+        } else if (b[j] < a[i]) {
+            ++j;
+        } else {
+            f(a[i]);
+            ++count;
+            ++i;
+            ++j;
+        }
+    }
+    return count;
+}
+
+#endif  // SRC_FEATURES_KERNELS_H_
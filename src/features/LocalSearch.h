@@ -0,0 +1,227 @@
+/*************************************************************************************************
+CNFTools -- Copyright (c) 2021, Markus Iser, KIT - Karlsruhe Institute of Technology
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT
+OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ **************************************************************************************************/
+
+#ifndef SRC_FEATURES_LOCALSEARCH_H_
+#define SRC_FEATURES_LOCALSEARCH_H_
+
+#include <math.h>
+
+#include <cstdint>
+#include <vector>
+#include <atomic>
+
+#include "src/util/SolverTypes.h"
+#include "src/util/CNFFormula.h"
+#include "src/util/InvariantHash.h"
+#include "src/util/ResourceLimits.h"
+#include "src/util/ThreadPool.h"
+
+/**
+ * Local search probes (cf. SATzilla): short runs of probSAT (break-only polynomial variant) from random assignments,
+ * each with its own seed and a fixed flip budget, such that results are reproducible and do not depend on the
+ * number of threads. Clauses and literal occurrences are stored in flat arrays which are shared by all probes;
+ * each probe keeps true literal counts and the xor of the true variables per clause, from which break counts
+ * are updated in constant time per occurrence of the flipped variable.
+ */
+class LocalSearch {
+ public:
+    struct Probe {
+        uint64_t best_unsat = 0;  // minimum number of unsatisfied clauses
+        uint64_t best_flip = 0;  // flip at which the minimum was first reached
+        double mean_unsat = 0;  // mean number of unsatisfied clauses in the second half of the probe
+        double autocorrelation = 0;  // lag-1 autocorrelation of the number of unsatisfied clauses in the second half
+        bool solved = false;
+    };
+
+ private:
+    const ResourceLimits& limits_;
+    unsigned threads_;
+    unsigned n_vars_;
+    std::vector<uint64_t> clause_offsets_;
+    std::vector<uint32_t> literals_;
+    std::vector<uint64_t> occurrence_offsets_;  // per literal
+    std::vector<uint32_t> occurrences_;  // clause indices
+    uint64_t empty_ = 0;  // empty clauses (always unsatisfied)
+
+    static constexpr double cb = 2.3;  // probSAT break exponent
+    static constexpr unsigned max_break = 64;
+    double probability_[max_break];
+
+    static inline double uniform(uint64_t seed, uint64_t* counter) {
+        return (mix64(++*counter, seed) >> 11) * 0x1.0p-53;
+    }
+
+    // returns false if the resource limits are exceeded during the probe (checked every 2^16 flips)
+    bool probe(uint64_t seed, uint64_t flips, std::atomic<bool>* exceeded, Probe* result) const {
+        const size_t n_clauses = clause_offsets_.size() - 1;
+        std::vector<uint8_t> value(n_vars_ + 1);
+        std::vector<uint32_t> true_count(n_clauses, 0), true_vars(n_clauses, 0);  // xor of the variables of true literals
+        std::vector<uint32_t> breaks(n_vars_ + 1, 0);
+        std::vector<uint32_t> unsat, position(n_clauses);
+        uint64_t counter = 0;
+        for (unsigned v = 0; v <= n_vars_; v++) {
+            value[v] = uniform(seed, &counter) < 0.5;
+        }
+        for (size_t c = 0; c < n_clauses; c++) {
+            if (clause_offsets_[c] == clause_offsets_[c + 1]) continue;
+            for (uint64_t i = clause_offsets_[c]; i < clause_offsets_[c + 1]; i++) {
+                const uint32_t lit = literals_[i];
+                if (value[lit >> 1] != (lit & 1)) {
+                    ++true_count[c];
+                    true_vars[c] ^= lit >> 1;
+                }
+            }
+            if (true_count[c] == 0) {
+                position[c] = unsat.size();
+                unsat.push_back(c);
+            } else if (true_count[c] == 1) {
+                ++breaks[true_vars[c]];
+            }
+        }
+
+        auto flip = [&] (uint32_t var) {
+            value[var] ^= 1;
+            const uint32_t made = 2 * var + !value[var], lost = made ^ 1;
+            for (uint64_t i = occurrence_offsets_[made]; i < occurrence_offsets_[made + 1]; i++) {
+                const uint32_t c = occurrences_[i];
+                if (true_count[c] == 0) {
+                    unsat[position[c]] = unsat.back();
+                    position[unsat.back()] = position[c];
+                    unsat.pop_back();
+                    ++breaks[var];
+                } else if (true_count[c] == 1) {
+                    --breaks[true_vars[c]];
+                }
+                ++true_count[c];
+                true_vars[c] ^= var;
+            }
+            for (uint64_t i = occurrence_offsets_[lost]; i < occurrence_offsets_[lost + 1]; i++) {
+                const uint32_t c = occurrences_[i];
+                --true_count[c];
+                true_vars[c] ^= var;
+                if (true_count[c] == 0) {
+                    position[c] = unsat.size();
+                    unsat.push_back(c);
+                    --breaks[var];
+                } else if (true_count[c] == 1) {
+                    ++breaks[true_vars[c]];
+                }
+            }
+        };
+
+        result->best_unsat = unsat.size() + empty_;
+        result->best_flip = 0;
+        double sum = 0, sumsq = 0, lagged = 0, first = 0, last = 0;
+        uint64_t samples = 0;
+        for (uint64_t f = 0; f < flips && !unsat.empty(); f++) {
+            if ((f & 0xFFFF) == 0xFFFF && (*exceeded || !limits_.within_limits())) return false;
+            const uint32_t c = unsat[mix64(++counter, seed) % unsat.size()];
+            double weights[max_break], total = 0;
+            const uint64_t begin = clause_offsets_[c], size = clause_offsets_[c + 1] - begin;
+            for (uint64_t i = 0; i < size && i < max_break; i++) {
+                weights[i] = probability_[std::min(breaks[literals_[begin + i] >> 1], max_break - 1)];
+                total += weights[i];
+            }
+            double r = uniform(seed, &counter) * total;
+            uint64_t pick = 0;
+            while (pick + 1 < std::min<uint64_t>(size, max_break) && r >= weights[pick]) {
+                r -= weights[pick++];
+            }
+            flip(literals_[begin + pick] >> 1);
+
+            const uint64_t current = unsat.size() + empty_;
+            if (current < result->best_unsat) {
+                result->best_unsat = current;
+                result->best_flip = f + 1;
+            }
+            if (2 * f >= flips) {
+                const double x = current;
+                if (samples == 0) first = x; else lagged += x * last;
+                sum += x;
+                sumsq += x * x;
+                last = x;
+                ++samples;
+            }
+        }
+        result->solved = unsat.empty() && empty_ == 0;
+        if (samples > 0) {
+            const double mean = sum / samples;
+            result->mean_unsat = mean;
+            const double variance = sumsq - samples * mean * mean;
+            if (samples > 1 && variance > 1e-9 * sumsq) {
+                const double covariance = lagged - mean * (2 * sum - first - last) + (samples - 1) * mean * mean;
+                result->autocorrelation = covariance / variance;
+            }
+        } else {
+            result->mean_unsat = result->best_unsat;
+        }
+        return true;
+    }
+
+ public:
+    static constexpr unsigned default_probes = 8;
+    static constexpr uint64_t default_flips = 1 << 20;
+
+    std::vector<Probe> probes;
+
+    LocalSearch(const CNFFormula& formula, const ResourceLimits& limits, unsigned threads = 1) :
+     limits_(limits), threads_(ThreadPool::resolve(threads)), n_vars_(formula.nVars()) {
+        clause_offsets_.reserve(formula.nClauses() + 1);
+        clause_offsets_.push_back(0);
+        occurrence_offsets_.assign(2 * (n_vars_ + 1) + 1, 0);
+        for (const Cl* clause : formula) {
+            for (Lit lit : *clause) {
+                literals_.push_back(lit.x);
+                ++occurrence_offsets_[lit.x + 1];
+            }
+            clause_offsets_.push_back(literals_.size());
+            if (clause->empty()) ++empty_;
+        }
+        for (size_t l = 0; l + 1 < occurrence_offsets_.size(); l++) {
+            occurrence_offsets_[l + 1] += occurrence_offsets_[l];
+        }
+        occurrences_.resize(literals_.size());
+        std::vector<uint64_t> fill(occurrence_offsets_.begin(), occurrence_offsets_.end() - 1);
+        for (size_t c = 0; c + 1 < clause_offsets_.size(); c++) {
+            for (uint64_t i = clause_offsets_[c]; i < clause_offsets_[c + 1]; i++) {
+                occurrences_[fill[literals_[i]]++] = c;
+            }
+        }
+        for (unsigned b = 0; b < max_break; b++) {
+            probability_[b] = pow(1.0 + b, -cb);
+        }
+    }
+
+    /**
+     * Runs the given number of probes (in parallel, probe i has seed i)
+     * @throws ResourceLimitsExceeded
+     */
+    void analyze(unsigned n_probes = default_probes, uint64_t flips = default_flips) {
+        probes.assign(n_probes, Probe());
+        std::atomic<bool> exceeded(false);
+        parallel_for(n_probes, threads_, [&] (unsigned, size_t begin, size_t end) {
+            for (size_t i = begin; i < end && !exceeded; i++) {
+                if (!probe(i, flips, &exceeded, &probes[i]) || !limits_.within_limits()) exceeded = true;
+            }
+        });
+        if (exceeded) throw ResourceLimitsExceeded();
+    }
+};
+
+#endif  // SRC_FEATURES_LOCALSEARCH_H_
@@ -0,0 +1,162 @@
+/*************************************************************************************************
+CNFTools -- Copyright (c) 2021, Markus Iser, KIT - Karlsruhe Institute of Technology
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT
+OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ **************************************************************************************************/
+
+#ifndef SRC_FEATURES_POWERLAW_H_
+#define SRC_FEATURES_POWERLAW_H_
+
+#include <math.h>
+
+#include <cstdint>
+#include <vector>
+#include <algorithm>
+
+/**
+ * Discrete power-law fit P(x) = x^-alpha / zeta(alpha, x_min) for x >= x_min (Clauset, Shalizi and Newman, 2009)
+ * over a histogram (frequency of each value), such that the cost depends on the number of distinct values only.
+ * For a given x_min, alpha maximizes the (concave) log-likelihood -n ln zeta(alpha, x_min) - alpha sum ln x
+ * (golden-section search, Hurwitz zeta by Euler-Maclaurin summation). x_min minimizes the Kolmogorov-Smirnov distance
+ * between the tail and the fit, where candidates are the distinct values with at least min_tail samples above them;
+ * the search scans a fixed number of candidates and then refines around the best one with halving steps.
+ * If the likelihood is maximal on the bound of the alpha interval (e.g. no heavy tail), the fit is not a power law and
+ * alpha and its error are reported as NaN.
+ */
+class PowerLaw {
+    std::vector<uint64_t> values_;  // distinct values >= 1 (ascending)
+    std::vector<uint64_t> tail_;  // number of samples >= values_[i]
+    std::vector<double> tail_log_;  // sum of ln x over the samples >= values_[i]
+
+    struct Fit {
+        double alpha = 0;
+        double ks = 1;
+    };
+
+    // Hurwitz zeta function sum_{k >= q} k^-s for s > 1 and q >= 1
+    static double zeta(double s, double q) {
+        double sum = 0;
+        for (; q < 32; q += 1) sum += pow(q, -s);
+        // Euler-Maclaurin: q^(1-s) / (s-1) + q^-s / 2 + sum_j B_2j / (2j)! * s (s+1) ... (s+2j-2) q^(-s-2j+1)
+        static const double bernoulli[] = { 1.0 / 12, -1.0 / 720, 1.0 / 30240, -1.0 / 1209600, 1.0 / 47900160 };
+        const double power = pow(q, -s);
+        sum += power * q / (s - 1) + power / 2;
+        double term = power * s / q;
+        for (unsigned j = 0; j < 5; j++) {
+            sum += bernoulli[j] * term;
+            term *= (s + 2 * j + 1) * (s + 2 * j + 2) / (q * q);
+        }
+        return sum;
+    }
+
+    Fit fit(size_t candidate) const {
+        Fit result;
+        const double n = tail_[candidate], x_min = values_[candidate];
+        const double log_sum = tail_log_[candidate];
+        auto likelihood = [&] (double alpha) { return -n * log(zeta(alpha, x_min)) - alpha * log_sum; };
+        const double ratio = (sqrt(5.0) - 1) / 2;
+        double lo = min_alpha, hi = max_alpha;
+        double a = hi - ratio * (hi - lo), b = lo + ratio * (hi - lo);
+        double la = likelihood(a), lb = likelihood(b);
+        while (hi - lo > 1e-6) {
+            if (la < lb) {
+                lo = a;
+                a = b;
+                la = lb;
+                b = lo + ratio * (hi - lo);
+                lb = likelihood(b);
+            } else {
+                hi = b;
+                b = a;
+                lb = la;
+                a = hi - ratio * (hi - lo);
+                la = likelihood(a);
+            }
+        }
+        result.alpha = (lo + hi) / 2;
+
+        // supremum over all integers x >= x_min of |P(X >= x) - S(x)|, where S is the empirical tail and P the fit:
+        // S is constant between distinct values, so it suffices to compare at each distinct value and its successor
+        const double normalization = zeta(result.alpha, x_min);
+        result.ks = 0;
+        for (size_t i = candidate; i < values_.size(); i++) {
+            const double empirical = tail_[i] / n;
+            const double next = i + 1 < values_.size() ? tail_[i + 1] / n : 0;
+            result.ks = std::max(result.ks, fabs(zeta(result.alpha, values_[i]) / normalization - empirical));
+            result.ks = std::max(result.ks, fabs(zeta(result.alpha, values_[i] + 1) / normalization - next));
+        }
+        return result;
+    }
+
+ public:
+    static constexpr uint64_t min_tail = 50;  // minimum number of samples >= x_min
+    static constexpr unsigned scan = 32;  // candidates of the initial scan
+    static constexpr double min_alpha = 1.0001, max_alpha = 10;
+    static constexpr double bound_tolerance = 1e-4;  // fits closer to min_alpha or max_alpha are on the bound
+
+    double alpha = 0;  // NaN if the fit is on the bound of [min_alpha, max_alpha]
+    double alpha_error = 0;  // standard error (alpha - 1) / sqrt(n)
+    uint64_t x_min = 0;
+    uint64_t n_tail = 0;  // samples >= x_min
+    double ks = 0;  // Kolmogorov-Smirnov distance between the tail and the fit
+
+    // histogram[x] is the number of samples with value x (samples with value 0 are ignored)
+    explicit PowerLaw(const std::vector<uint64_t>& histogram) {
+        for (size_t x = 1; x < histogram.size(); x++) {
+            if (histogram[x] > 0) {
+                values_.push_back(x);
+                tail_.push_back(histogram[x]);
+                tail_log_.push_back(histogram[x] * log(x));
+            }
+        }
+        for (size_t i = values_.size(); i-- > 1; ) {
+            tail_[i - 1] += tail_[i];
+            tail_log_[i - 1] += tail_log_[i];
+        }
+    }
+
+    void analyze() {
+        if (values_.empty() || tail_[0] < 2) return;
+        size_t candidates = 1;  // the smallest value is a candidate even if there are fewer than min_tail samples
+        while (candidates < values_.size() && tail_[candidates] >= min_tail) ++candidates;
+        size_t best = 0;
+        Fit best_fit = fit(0);
+        auto consider = [&] (size_t candidate) {
+            const Fit result = fit(candidate);
+            if (result.ks < best_fit.ks) {
+                best = candidate;
+                best_fit = result;
+            }
+        };
+        const size_t step = std::max<size_t>(1, candidates / scan);
+        for (size_t c = step; c < candidates; c += step) consider(c);
+        for (size_t s = step / 2; s > 0; s /= 2) {
+            const size_t center = best;
+            if (center >= s) consider(center - s);
+            if (center + s < candidates) consider(center + s);
+        }
+        alpha = best_fit.alpha;
+        ks = best_fit.ks;
+        x_min = values_[best];
+        n_tail = tail_[best];
+        alpha_error = (alpha - 1) / sqrt(n_tail);
+        if (alpha - min_alpha < bound_tolerance || max_alpha - alpha < bound_tolerance) {
+            alpha = alpha_error = NAN;
+        }
+    }
+};
+
+#endif  // SRC_FEATURES_POWERLAW_H_
@@ -0,0 +1,270 @@
+/*************************************************************************************************
+CNFTools -- Copyright (c) 2021, Markus Iser, KIT - Karlsruhe Institute of Technology
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT
+OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ **************************************************************************************************/
+
+#ifndef SRC_FEATURES_PROPAGATION_H_
+#define SRC_FEATURES_PROPAGATION_H_
+
+#include <cstdint>
+#include <vector>
+#include <algorithm>
+
+#include "src/util/SolverTypes.h"
+#include "src/util/CNFFormula.h"
+#include "src/util/InvariantHash.h"
+#include "src/util/ResourceLimits.h"
+#include "src/util/ThreadPool.h"
+
+#include "src/features/Util.h"
+
+/**
+ * Failed literal probing: each probed literal is assigned on top of the root level (units of the formula)
+ * and unit propagation counts its implications and the depth of the propagation (number of breadth-first
+ * generations) or detects a conflict. Probes do not change the formula, such that they are independent of each other.
+ * Binary clauses are stored as implication lists, longer clauses are propagated by two watched literals in flat arrays,
+ * where the watch list of each literal has the capacity of its number of occurrences. Probes run in parallel on
+ * fixed batches of literals: each batch starts from a copy of the root state (clause arena, watches and
+ * assignment), which the probes of the batch then modify, such that results do not depend on the number of threads.
+ */
+class Propagation {
+    const CNFFormula& formula_;
+    const ResourceLimits& limits_;
+    unsigned threads_;
+
+    struct Watcher {
+        uint32_t clause;
+        uint32_t blocker;
+    };
+
+    // Mutable propagation state (the root state is copied for each batch)
+    struct State {
+        std::vector<uint32_t> arena;  // literals of long clauses (watched literals first)
+        std::vector<Watcher> watches;  // watch list of literal l in watches[watch_offsets[l] .. watch_offsets[l] + watch_sizes[l])
+        std::vector<uint32_t> watch_sizes;
+        std::vector<int8_t> value;  // per literal: 1 true, -1 false, 0 unassigned
+        std::vector<uint32_t> trail;
+
+        void copy(const State& other) {
+            arena.assign(other.arena.begin(), other.arena.end());
+            watches.assign(other.watches.begin(), other.watches.end());
+            watch_sizes.assign(other.watch_sizes.begin(), other.watch_sizes.end());
+            value.assign(other.value.begin(), other.value.end());
+            trail.clear();
+        }
+    };
+
+    std::vector<uint64_t> implication_offsets_;  // binary clauses: literals implied by literal l
+    std::vector<uint32_t> implications_;
+    std::vector<uint64_t> clause_offsets_;  // long clauses in the arena
+    std::vector<uint64_t> watch_offsets_;
+    State root_;
+
+    static constexpr unsigned batch = 1 << 12;  // probes per batch
+
+    inline bool assign(State* state, uint32_t lit) const {
+        if (state->value[lit] != 0) return state->value[lit] > 0;
+        state->value[lit] = 1;
+        state->value[lit ^ 1] = -1;
+        state->trail.push_back(lit);
+        return true;
+    }
+
+    /**
+     * Propagates the trail from the given position, returns false on conflict (the depth is the number of
+     * generations, where the literals of generation g + 1 are implied while propagating generation g)
+     */
+    bool propagate(State* state, size_t head, unsigned* depth) const {
+        size_t generation_end = state->trail.size();
+        *depth = 0;
+        for (; head < state->trail.size(); head++) {
+            if (head == generation_end) {
+                ++*depth;
+                generation_end = state->trail.size();
+            }
+            const uint32_t lit = state->trail[head];
+            for (uint64_t i = implication_offsets_[lit]; i < implication_offsets_[lit + 1]; i++) {
+                if (!assign(state, implications_[i])) return false;
+            }
+            // clauses watching the literal which became false
+            const uint32_t falsified = lit ^ 1;
+            Watcher* watches = state->watches.data() + watch_offsets_[falsified];
+            uint32_t i = 0, j = 0;
+            const uint32_t n = state->watch_sizes[falsified];
+            bool conflict = false;
+            while (i < n) {
+                const Watcher watcher = watches[i++];
+                if (state->value[watcher.blocker] > 0) {
+                    watches[j++] = watcher;
+                    continue;
+                }
+                uint32_t* lits = state->arena.data() + clause_offsets_[watcher.clause];
+                const uint32_t size = clause_offsets_[watcher.clause + 1] - clause_offsets_[watcher.clause];
+                if (lits[0] == falsified) std::swap(lits[0], lits[1]);
+                const uint32_t first = lits[0];
+                if (first != watcher.blocker && state->value[first] > 0) {
+                    watches[j++] = Watcher { watcher.clause, first };
+                    continue;
+                }
+                bool moved = false;
+                for (uint32_t k = 2; k < size; k++) {
+                    if (state->value[lits[k]] >= 0) {
+                        std::swap(lits[1], lits[k]);
+                        state->watches[watch_offsets_[lits[1]] + state->watch_sizes[lits[1]]++] = Watcher { watcher.clause, first };
+                        moved = true;
+                        break;
+                    }
+                }
+                if (moved) continue;
+                watches[j++] = Watcher { watcher.clause, first };
+                if (!assign(state, first)) {
+                    conflict = true;
+                    break;
+                }
+            }
+            while (i < n) watches[j++] = watches[i++];
+            state->watch_sizes[falsified] = j;
+            if (conflict) return false;
+        }
+        return true;
+    }
+
+    void undo(State* state, size_t size) const {
+        while (state->trail.size() > size) {
+            const uint32_t lit = state->trail.back();
+            state->value[lit] = state->value[lit ^ 1] = 0;
+            state->trail.pop_back();
+        }
+    }
+
+ public:
+    static constexpr unsigned default_probes = 1 << 16;
+
+    bool root_conflict = false;
+    unsigned root_fixed = 0;  // variables fixed by unit propagation at the root level
+    uint64_t probed = 0;
+    uint64_t failed = 0;
+    Distribution<unsigned> implications;  // per probe (number of implied literals until fixpoint or conflict)
+    Distribution<unsigned> depths;  // per probe (number of propagation generations)
+
+    Propagation(const CNFFormula& formula, const ResourceLimits& limits, unsigned threads = 1) :
+     formula_(formula), limits_(limits), threads_(ThreadPool::resolve(threads)) {
+        const size_t n_lits = 2 * (formula.nVars() + 1);
+        implication_offsets_.assign(n_lits + 1, 0);
+        watch_offsets_.assign(n_lits + 1, 0);
+        for (const Cl* clause : formula) {
+            if (clause->size() == 2) {
+                ++implication_offsets_[(*clause)[0].x ^ 1];
+                ++implication_offsets_[(*clause)[1].x ^ 1];
+            } else if (clause->size() > 2) {
+                for (Lit lit : *clause) ++watch_offsets_[lit.x];
+            }
+        }
+        // exclusive prefix sums (watch capacities are the occurrence counts in long clauses)
+        uint64_t sum_implications = 0, sum_watches = 0;
+        for (size_t l = 0; l <= n_lits; l++) {
+            uint64_t count = implication_offsets_[l];
+            implication_offsets_[l] = sum_implications;
+            sum_implications += count;
+            count = watch_offsets_[l];
+            watch_offsets_[l] = sum_watches;
+            sum_watches += count;
+        }
+        implications_.resize(sum_implications);
+        root_.watches.resize(sum_watches);
+        root_.watch_sizes.assign(n_lits, 0);
+        root_.value.assign(n_lits, 0);
+        clause_offsets_.push_back(0);
+        std::vector<uint64_t> fill(implication_offsets_.begin(), implication_offsets_.end() - 1);
+        std::vector<uint32_t> units;
+        for (const Cl* clause : formula) {
+            if (clause->empty()) {
+                root_conflict = true;
+            } else if (clause->size() == 1) {
+                units.push_back((*clause)[0].x);
+            } else if (clause->size() == 2) {
+                implications_[fill[(*clause)[0].x ^ 1]++] = (*clause)[1].x;
+                implications_[fill[(*clause)[1].x ^ 1]++] = (*clause)[0].x;
+            } else {
+                const uint32_t index = clause_offsets_.size() - 1;
+                for (Lit lit : *clause) root_.arena.push_back(lit.x);
+                clause_offsets_.push_back(root_.arena.size());
+                for (unsigned w = 0; w < 2; w++) {
+                    const uint32_t lit = (*clause)[w].x;
+                    root_.watches[watch_offsets_[lit] + root_.watch_sizes[lit]++] = Watcher { index, (*clause)[1 - w].x };
+                }
+            }
+        }
+        for (uint32_t unit : units) {
+            if (!assign(&root_, unit)) root_conflict = true;
+        }
+        unsigned depth;
+        if (!root_conflict && !propagate(&root_, 0, &depth)) root_conflict = true;
+        root_fixed = root_.trail.size();
+        root_.trail.clear();
+    }
+
+    /**
+     * Probes both literals of up to max_probes / 2 unassigned variables (chosen by hash of the variable)
+     * @throws ResourceLimitsExceeded
+     */
+    void analyze(uint64_t max_probes = default_probes) {
+        if (root_conflict) return;
+        std::vector<uint32_t> candidates;
+        for (unsigned v = 1; v <= formula_.nVars(); v++) {
+            if (root_.value[2 * v] == 0) candidates.push_back(v);
+        }
+        if (candidates.size() > max_probes / 2) {
+            std::sort(candidates.begin(), candidates.end(), [] (uint32_t a, uint32_t b) {
+                return mix64(a) < mix64(b) || (mix64(a) == mix64(b) && a < b);
+            });
+            candidates.resize(max_probes / 2);
+        }
+        std::vector<uint32_t> literals;
+        for (uint32_t v : candidates) {
+            literals.push_back(2 * v);
+            literals.push_back(2 * v + 1);
+        }
+        probed = literals.size();
+
+        const size_t n_batches = (literals.size() + batch - 1) / batch;
+        std::vector<State> states(threads_);
+        std::vector<uint64_t> fails(threads_, 0);
+        std::vector<Distribution<unsigned>> local_implications(threads_), local_depths(threads_);
+        for_each_chunk(n_batches, threads_, limits_, [&] (unsigned t, size_t begin, size_t end) {
+            State& state = states[t];
+            for (size_t b = begin; b < end; b++) {
+                state.copy(root_);
+                for (size_t i = b * batch; i < std::min<size_t>((b + 1) * batch, literals.size()); i++) {
+                    unsigned depth = 0;
+                    assign(&state, literals[i]);
+                    if (!propagate(&state, 0, &depth)) ++fails[t];
+                    local_implications[t].add(state.trail.size() - 1);
+                    local_depths[t].add(depth);
+                    undo(&state, 0);
+                }
+            }
+        }, 1);
+        for (unsigned t = 0; t < threads_; t++) {
+            failed += fails[t];
+            implications.merge(local_implications[t]);
+            depths.merge(local_depths[t]);
+        }
+    }
+};
+
+#endif  // SRC_FEATURES_PROPAGATION_H_
@@ -0,0 +1,228 @@
+/*************************************************************************************************
+CNFTools -- Copyright (c) 2021, Markus Iser, KIT - Karlsruhe Institute of Technology
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT
+OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ **************************************************************************************************/
+
+#ifndef SRC_FEATURES_SPECTRAL_H_
+#define SRC_FEATURES_SPECTRAL_H_
+
+#include <math.h>
+
+#include <cstdint>
+#include <vector>
+#include <algorithm>
+
+#include "src/util/CSRGraph.h"
+#include "src/util/InvariantHash.h"
+#include "src/util/ResourceLimits.h"
+#include "src/util/ThreadPool.h"
+
+/**
+ * Leading eigenvalues of an undirected graph by the Lanczos method with O(n) memory (three-term recurrence without
+ * reorthogonalization, the largest Ritz value is computed by bisection on the tridiagonal matrix):
+ * the spectral radius of the adjacency matrix A and the second largest eigenvalue of the normalized adjacency matrix
+ * D^-1/2 A D^-1/2, whose leading eigenvector D^1/2 1 is known and projected out in each step.
+ * The matrix-vector product runs in parallel over rows, and dot products are summed in fixed blocks,
+ * such that results do not depend on the number of threads.
+ */
+class Spectral {
+    const CSRGraph& graph_;
+    const ResourceLimits& limits_;
+    unsigned threads_;
+
+    std::vector<double> scale_;  // D^-1/2 (empty for the adjacency matrix)
+    std::vector<double> deflate_;  // unit vector which is projected out (empty for none)
+    std::vector<double> scaled_;  // S x
+
+    static constexpr size_t block = 1 << 12;
+
+    double dot(const std::vector<double>& a, const std::vector<double>& b) const {
+        std::vector<double> partial((a.size() + block - 1) / block, 0);
+        parallel_for(partial.size(), threads_, [&] (unsigned, size_t begin, size_t end) {
+            for (size_t k = begin; k < end; k++) {
+                double sum = 0;
+                for (size_t i = k * block; i < std::min((k + 1) * block, a.size()); i++) sum += a[i] * b[i];
+                partial[k] = sum;
+            }
+        });
+        double sum = 0;
+        for (double p : partial) sum += p;
+        return sum;
+    }
+
+    // y = x - (u.x) u for the deflated vector u
+    void project(std::vector<double>* x) const {
+        if (deflate_.empty()) return;
+        const double d = dot(deflate_, *x);
+        parallel_for(x->size(), threads_, [&] (unsigned, size_t begin, size_t end) {
+            for (size_t i = begin; i < end; i++) (*x)[i] -= d * deflate_[i];
+        });
+    }
+
+    // y = P S A S P x, where S is the scaling and P the projection
+    void apply(std::vector<double>* x, std::vector<double>* y) {
+        project(x);
+        const double* source = x->data();
+        if (!scale_.empty()) {
+            scaled_.resize(x->size());
+            parallel_for(x->size(), threads_, [&] (unsigned, size_t begin, size_t end) {
+                for (size_t i = begin; i < end; i++) scaled_[i] = scale_[i] * (*x)[i];
+            });
+            source = scaled_.data();
+        }
+        for_each_chunk(graph_.size(), threads_, limits_, [&] (unsigned, size_t begin, size_t end) {
+            for (size_t v = begin; v < end; v++) {
+                double sum = 0;
+                for (const unsigned* w = graph_.begin(v); w != graph_.end(v); ++w) {
+                    sum += source[*w];
+                }
+                (*y)[v] = sum;
+            }
+        }, 1 << 14);
+        if (!scale_.empty()) {
+            parallel_for(y->size(), threads_, [&] (unsigned, size_t begin, size_t end) {
+                for (size_t i = begin; i < end; i++) (*y)[i] *= scale_[i];
+            });
+        }
+        project(y);
+    }
+
+    // Largest eigenvalue of the symmetric tridiagonal matrix with diagonal alpha and off-diagonal beta (bisection)
+    static double largest_eigenvalue(const std::vector<double>& alpha, const std::vector<double>& beta) {
+        const size_t k = alpha.size();
+        double lo = alpha[0], hi = alpha[0];
+        for (size_t i = 0; i < k; i++) {
+            const double radius = (i > 0 ? fabs(beta[i - 1]) : 0) + (i + 1 < k ? fabs(beta[i]) : 0);
+            lo = std::min(lo, alpha[i] - radius);
+            hi = std::max(hi, alpha[i] + radius);
+        }
+        auto below = [&] (double x) {  // number of eigenvalues < x (Sturm sequence)
+            size_t count = 0;
+            double d = 1;
+            for (size_t i = 0; i < k; i++) {
+                d = alpha[i] - x - (i > 0 ? beta[i - 1] * beta[i - 1] / d : 0);
+                if (d == 0) d = -1e-300;
+                if (d < 0) ++count;
+            }
+            return count;
+        };
+        for (unsigned step = 0; step < 100 && hi - lo > 1e-12 * std::max(1.0, fabs(hi)); step++) {
+            const double mid = (lo + hi) / 2;
+            if (below(mid) == k) hi = mid; else lo = mid;
+        }
+        return (lo + hi) / 2;
+    }
+
+    // Absolute value of the last component of the unit eigenvector of the tridiagonal matrix for eigenvalue theta
+    // (inverse iteration, solved by Gaussian elimination without pivoting)
+    static double last_component(const std::vector<double>& alpha, const std::vector<double>& beta, double theta) {
+        const size_t k = alpha.size();
+        const double shift = theta + 1e-10 * std::max(1.0, fabs(theta));
+        std::vector<double> x(k, 1), diagonal(k), upper(k);
+        for (unsigned step = 0; step < 3; step++) {
+            diagonal[0] = alpha[0] - shift;
+            for (size_t i = 1; i < k; i++) {  // forward elimination
+                if (diagonal[i - 1] == 0) diagonal[i - 1] = 1e-300;
+                const double factor = beta[i - 1] / diagonal[i - 1];
+                diagonal[i] = alpha[i] - shift - factor * beta[i - 1];
+                x[i] -= factor * x[i - 1];
+            }
+            if (diagonal[k - 1] == 0) diagonal[k - 1] = 1e-300;
+            x[k - 1] /= diagonal[k - 1];
+            for (size_t i = k - 1; i-- > 0; ) {  // back substitution
+                x[i] = (x[i] - beta[i] * x[i + 1]) / diagonal[i];
+            }
+            double norm = 0;
+            for (double xi : x) norm += xi * xi;
+            norm = sqrt(norm);
+            for (double& xi : x) xi /= norm;
+        }
+        return fabs(x[k - 1]);
+    }
+
+    // Largest eigenvalue of the current operator
+    double lanczos() {
+        const size_t n = graph_.size();
+        std::vector<double> q(n), previous(n, 0), w(n);
+        for (size_t v = 0; v < n; v++) {
+            q[v] = graph_.degree(v) > 0 ? (mix64(v, 0x5bec) >> 11) * 0x1.0p-52 - 1 : 0;
+        }
+        project(&q);
+        double norm = sqrt(dot(q, q));
+        if (norm == 0) return 0;
+        for (double& x : q) x /= norm;
+        std::vector<double> alpha, beta;
+        double theta = 0, beta_previous = 0;
+        for (unsigned k = 0; k < max_iterations; k++) {
+            apply(&q, &w);
+            const double a = dot(w, q);
+            parallel_for(n, threads_, [&] (unsigned, size_t begin, size_t end) {
+                for (size_t i = begin; i < end; i++) w[i] -= a * q[i] + beta_previous * previous[i];
+            });
+            const double b = sqrt(dot(w, w));
+            alpha.push_back(a);
+            theta = largest_eigenvalue(alpha, beta);
+            ++iterations;
+            // residual norm of the Ritz pair: b * |last component of the eigenvector of T|
+            const double residual = b * last_component(alpha, beta, theta);
+            if (residual <= tolerance * std::max(1.0, fabs(theta))) {
+                break;
+            }
+            beta.push_back(b);
+            beta_previous = b;
+            previous.swap(q);
+            parallel_for(n, threads_, [&] (unsigned, size_t begin, size_t end) {
+                for (size_t i = begin; i < end; i++) q[i] = w[i] / b;
+            });
+        }
+        return theta;
+    }
+
+ public:
+    static constexpr unsigned max_iterations = 300;
+    static constexpr double tolerance = 1e-4;  // relative residual of the largest Ritz pair
+
+    double spectral_radius = 0;  // largest eigenvalue of A
+    double lambda_2 = 0;  // second largest eigenvalue of D^-1/2 A D^-1/2 (1 if the graph is not connected)
+    unsigned iterations = 0;  // Lanczos steps of both runs
+
+    Spectral(const CSRGraph& graph, const ResourceLimits& limits, unsigned threads = 1) :
+        graph_(graph), limits_(limits), threads_(ThreadPool::resolve(threads)) { }
+
+    /**
+     * @throws ResourceLimitsExceeded
+     */
+    void analyze() {
+        scale_.clear();
+        deflate_.clear();
+        spectral_radius = lanczos();
+
+        const size_t n = graph_.size();
+        scale_.resize(n);
+        deflate_.resize(n);
+        for (size_t v = 0; v < n; v++) {
+            scale_[v] = graph_.degree(v) > 0 ? 1 / sqrt(graph_.degree(v)) : 0;
+            deflate_[v] = sqrt(graph_.degree(v));
+        }
+        const double norm = sqrt(dot(deflate_, deflate_));
+        if (norm == 0) return;
+        for (double& x : deflate_) x /= norm;
+        lambda_2 = lanczos();
+    }
+};
+
+#endif  // SRC_FEATURES_SPECTRAL_H_
@@ -0,0 +1,357 @@
+/*************************************************************************************************
+CNFTools -- Copyright (c) 2021, Markus Iser, KIT - Karlsruhe Institute of Technology
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT
+OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ **************************************************************************************************/
+
+#ifndef SRC_FEATURES_TREEWIDTH_H_
+#define SRC_FEATURES_TREEWIDTH_H_
+
+#include <climits>
+#include <atomic>
+#include <cstdint>
+#include <vector>
+#include <algorithm>
+
+#include "src/util/CSRGraph.h"
+#include "src/util/ResourceLimits.h"
+#include "src/util/ThreadPool.h"
+
+/**
+ * Bucket priority queue of vertices with integer keys (keys above max_key share the last bucket)
+ */
+class BucketQueue {
+    static constexpr unsigned none = UINT_MAX;
+    unsigned max_key_;
+    std::vector<unsigned> head_;
+    std::vector<unsigned> next_, prev_, bucket_;
+    unsigned min_ = 0;
+    size_t size_ = 0;
+
+ public:
+    BucketQueue(size_t n, unsigned max_key) :
+        max_key_(max_key), head_(max_key + 1, none), next_(n, none), prev_(n, none), bucket_(n, none) { }
+
+    inline bool empty() const {
+        return size_ == 0;
+    }
+
+    void push(unsigned v, unsigned key) {
+        const unsigned b = std::min(key, max_key_);
+        bucket_[v] = b;
+        prev_[v] = none;
+        next_[v] = head_[b];
+        if (head_[b] != none) prev_[head_[b]] = v;
+        head_[b] = v;
+        min_ = std::min(min_, b);
+        ++size_;
+    }
+
+    void erase(unsigned v) {
+        if (prev_[v] != none) next_[prev_[v]] = next_[v]; else head_[bucket_[v]] = next_[v];
+        if (next_[v] != none) prev_[next_[v]] = prev_[v];
+        bucket_[v] = none;
+        --size_;
+    }
+
+    void update(unsigned v, unsigned key) {
+        if (bucket_[v] == std::min(key, max_key_)) return;
+        erase(v);
+        push(v, key);
+    }
+
+    // vertex with minimal key (the queue must not be empty)
+    unsigned top() {
+        while (head_[min_] == none) ++min_;
+        return head_[min_];
+    }
+};
+
+/**
+ * Upper bounds of the treewidth of a graph by greedy elimination orderings (min-degree and min-fill):
+ * the width of an ordering is the maximal number of neighbours of a vertex when it is eliminated (its neighbours
+ * become a clique). Vertices are selected from bucket queues; min-fill keys of the neighbours of an eliminated vertex
+ * are updated immediately, those of vertices adjacent to two or more of them are marked stale and updated when they
+ * reach the top.
+ * Adjacency lists are sparse until at most dense_vertices remain, which then continue on bitset adjacency rows.
+ * Min-fill continues by degree after fill_work adjacency operations (any ordering gives an upper bound).
+ * Elimination stops as soon as the width exceeds max_width (the reported width is then max_width + 1), which is
+ * also known in advance if the degeneracy (a lower bound) exceeds max_width.
+ * Both heuristics run in parallel if two threads are available.
+ */
+class Treewidth {
+    const CSRGraph& graph_;
+    const ResourceLimits& limits_;
+    unsigned threads_;
+
+    class SparseGraph {
+        std::vector<std::vector<unsigned>> adjacency_;
+        std::vector<unsigned> stamp_;
+        unsigned time_ = 0;
+
+     public:
+        uint64_t work = 0;  // of fill computations
+
+        explicit SparseGraph(const CSRGraph& graph) : adjacency_(graph.size()), stamp_(graph.size(), 0) {
+            for (unsigned v = 0; v < graph.size(); v++) adjacency_[v].assign(graph.begin(v), graph.end(v));
+        }
+
+        inline size_t size() const {
+            return adjacency_.size();
+        }
+
+        inline unsigned degree(unsigned v) const {
+            return adjacency_[v].size();
+        }
+
+        inline const std::vector<unsigned>& neighbours(unsigned v) const {
+            return adjacency_[v];
+        }
+
+        // number of missing edges among the neighbours of v
+        uint64_t fill(unsigned v) {
+            ++time_;
+            for (unsigned w : adjacency_[v]) stamp_[w] = time_;
+            uint64_t edges = 0;
+            for (unsigned a : adjacency_[v]) {
+                for (unsigned b : adjacency_[a]) edges += stamp_[b] == time_;
+                work += adjacency_[a].size();
+            }
+            const uint64_t d = adjacency_[v].size();
+            return d * (d - 1) / 2 - edges / 2;
+        }
+
+        void eliminate(unsigned v) {
+            const std::vector<unsigned>& clique = adjacency_[v];
+            for (unsigned u : clique) {
+                std::vector<unsigned>& list = adjacency_[u];
+                ++time_;
+                for (size_t i = 0; i < list.size(); ) {
+                    if (list[i] == v) {
+                        list[i] = list.back();
+                        list.pop_back();
+                    } else {
+                        stamp_[list[i++]] = time_;
+                    }
+                }
+                for (unsigned w : clique) {
+                    if (w != u && stamp_[w] != time_) list.push_back(w);
+                }
+            }
+            std::vector<unsigned>().swap(adjacency_[v]);
+        }
+    };
+
+    class DenseGraph {
+        size_t n_, words_;
+        std::vector<uint64_t> rows_;
+        std::vector<unsigned> degree_;
+
+        inline uint64_t* row(unsigned v) {
+            return rows_.data() + v * words_;
+        }
+
+     public:
+        uint64_t work = 0;  // of fill computations
+
+        // subgraph induced by the given vertices (renumbered in the given order)
+        DenseGraph(const SparseGraph& graph, const std::vector<unsigned>& vertices) :
+         n_(vertices.size()), words_((vertices.size() + 63) / 64), rows_(n_ * words_, 0), degree_(n_, 0) {
+            std::vector<unsigned> index(graph.size(), UINT_MAX);
+            for (unsigned i = 0; i < n_; i++) index[vertices[i]] = i;
+            for (unsigned i = 0; i < n_; i++) {
+                for (unsigned w : graph.neighbours(vertices[i])) {
+                    if (index[w] == UINT_MAX) continue;
+                    row(i)[index[w] / 64] |= uint64_t(1) << (index[w] % 64);
+                }
+                degree_[i] = graph.degree(vertices[i]);
+            }
+        }
+
+        inline size_t size() const {
+            return n_;
+        }
+
+        inline unsigned degree(unsigned v) const {
+            return degree_[v];
+        }
+
+        std::vector<unsigned> neighbours(unsigned v) {
+            std::vector<unsigned> result;
+            const uint64_t* r = row(v);
+            for (size_t k = 0; k < words_; k++) {
+                for (uint64_t bits = r[k]; bits != 0; bits &= bits - 1) result.push_back(k * 64 + __builtin_ctzll(bits));
+            }
+            return result;
+        }
+
+        uint64_t fill(unsigned v) {
+            const uint64_t* r = row(v);
+            uint64_t edges = 0;
+            for (unsigned a : neighbours(v)) {
+                const uint64_t* s = row(a);
+                for (size_t k = 0; k < words_; k++) edges += __builtin_popcountll(r[k] & s[k]);
+                work += words_;
+            }
+            const uint64_t d = degree_[v];
+            return d * (d - 1) / 2 - edges / 2;
+        }
+
+        void eliminate(unsigned v) {
+            uint64_t* r = row(v);
+            for (unsigned u : neighbours(v)) {
+                uint64_t* s = row(u);
+                unsigned degree = 0;
+                for (size_t k = 0; k < words_; k++) {
+                    s[k] |= r[k];
+                    if (k == u / 64) s[k] &= ~(uint64_t(1) << (u % 64));
+                    if (k == v / 64) s[k] &= ~(uint64_t(1) << (v % 64));
+                    degree += __builtin_popcountll(s[k]);
+                }
+                degree_[u] = degree;
+            }
+            std::fill(r, r + words_, 0);
+            degree_[v] = 0;
+        }
+    };
+
+    /**
+     * Eliminates the given vertices greedily until at most remaining are left (which are then left in vertices),
+     * returns the width (max_width + 1 if exceeded)
+     */
+    template <typename Graph>
+    unsigned eliminate(Graph* graph, std::vector<unsigned>* vertices, bool min_fill, size_t remaining) const {
+        const unsigned cap = max_width * max_width;  // exceeds the fill of vertices of degree <= max_width
+        bool by_fill = min_fill;
+        auto key = [&] (unsigned v) -> unsigned {
+            if (graph->degree(v) > max_width) return cap;
+            return by_fill ? graph->fill(v) : graph->degree(v);
+        };
+        BucketQueue queue(graph->size(), cap);
+        std::vector<bool> stale(graph->size(), false);
+        std::vector<bool> queued(graph->size(), false);
+        std::vector<unsigned> shared(graph->size(), 0);  // neighbours in the current clique
+        for (unsigned v : *vertices) {
+            queue.push(v, key(v));
+            queued[v] = true;
+        }
+        unsigned width = 0;
+        for (size_t left = vertices->size(), steps = 0; left > remaining; steps++) {
+            if ((steps & 0x3FF) == 0x3FF) limits_.within_limits_or_throw();
+            const unsigned v = queue.top();
+            if (stale[v]) {
+                stale[v] = false;
+                queue.update(v, key(v));
+                continue;
+            }
+            if (graph->degree(v) > max_width) return max_width + 1;
+            width = std::max(width, graph->degree(v));
+            const std::vector<unsigned> clique = graph->neighbours(v);
+            queue.erase(v);
+            queued[v] = false;
+            --left;
+            graph->eliminate(v);
+            if (by_fill) {  // new edges within the neighbourhood of vertices adjacent to two or more clique vertices
+                for (unsigned u : clique) {
+                    for (unsigned w : graph->neighbours(u)) if (queued[w] && ++shared[w] == 2) stale[w] = true;
+                }
+                for (unsigned u : clique) {
+                    for (unsigned w : graph->neighbours(u)) shared[w] = 0;
+                }
+            }
+            for (unsigned u : clique) {
+                queue.update(u, key(u));
+                stale[u] = false;
+            }
+            if (by_fill && graph->work > fill_work) {  // continue by degree
+                by_fill = false;
+                for (unsigned u : *vertices) if (queued[u]) {
+                    stale[u] = false;
+                    queue.update(u, key(u));
+                }
+            }
+        }
+        vertices->erase(std::remove_if(vertices->begin(), vertices->end(), [&queued] (unsigned v) { return !queued[v]; }),
+            vertices->end());
+        return width;
+    }
+
+    unsigned elimination_width(bool min_fill) const {
+        SparseGraph sparse(graph_);
+        std::vector<unsigned> vertices(graph_.size());
+        for (unsigned v = 0; v < graph_.size(); v++) vertices[v] = v;
+        const unsigned width = eliminate(&sparse, &vertices, min_fill, dense_vertices);
+        if (width > max_width || vertices.empty()) return width;
+        // continue on the remaining vertices with bitset rows
+        DenseGraph dense(sparse, vertices);
+        for (unsigned i = 0; i < vertices.size(); i++) vertices[i] = i;
+        return std::max(width, eliminate(&dense, &vertices, min_fill, 0));
+    }
+
+ public:
+    static constexpr unsigned max_width = 1 << 8;
+    static constexpr size_t dense_vertices = 1 << 12;
+    static constexpr uint64_t fill_work = uint64_t(1) << 30;  // adjacency operations of min-fill before falling back to min-degree
+
+    unsigned lower_bound = 0;  // degeneracy (maximal minimum degree of a subgraph)
+    unsigned min_degree = 0;  // width of the min-degree ordering
+    unsigned min_fill = 0;  // width of the min-fill ordering
+
+    Treewidth(const CSRGraph& graph, const ResourceLimits& limits, unsigned threads = 1) :
+        graph_(graph), limits_(limits), threads_(ThreadPool::resolve(threads)) { }
+
+    /**
+     * @throws ResourceLimitsExceeded
+     */
+    void analyze() {
+        BucketQueue queue(graph_.size(), max_width + 1);
+        std::vector<unsigned> degree(graph_.size());
+        for (unsigned v = 0; v < graph_.size(); v++) {
+            degree[v] = graph_.degree(v);
+            queue.push(v, degree[v]);
+        }
+        for (size_t left = graph_.size(); left > 0 && lower_bound <= max_width; left--) {
+            const unsigned v = queue.top();
+            lower_bound = std::max(lower_bound, degree[v]);
+            queue.erase(v);
+            degree[v] = UINT_MAX;
+            for (const unsigned* w = graph_.begin(v); w != graph_.end(v); ++w) {
+                if (degree[*w] != UINT_MAX) queue.update(*w, --degree[*w]);
+            }
+        }
+        lower_bound = std::min(lower_bound, max_width + 1);
+        if (lower_bound > max_width) {
+            min_degree = min_fill = max_width + 1;
+            return;
+        }
+        std::atomic<bool> exceeded(false);
+        unsigned width[2] = { 0, 0 };
+        parallel_for(2, threads_, [&] (unsigned, size_t begin, size_t end) {
+            for (size_t h = begin; h < end && !exceeded; h++) {
+                try {
+                    width[h] = elimination_width(h == 1);
+                } catch (const ResourceLimitsExceeded&) {
+                    exceeded = true;
+                }
+            }
+        });
+        if (exceeded) throw ResourceLimitsExceeded();
+        min_degree = width[0];
+        min_fill = width[1];
+    }
+};
+
+#endif  // SRC_FEATURES_TREEWIDTH_H_
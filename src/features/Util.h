@@ -21,74 +21,265 @@ OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWA
 #define SRC_FEATURES_UTIL_H_
 
 #include <math.h>
+#include <assert.h>
 
+#include <cstdint>
 #include <vector>
+#include <map>
 #include <algorithm>
 #include <numeric>
-// #include <execution>
+#include <type_traits>
+#include <utility>
+#include <string>
 
-template <typename T>
-float Mean(std::vector<T> distribution) {
-    float sum = static_cast<float>(std::accumulate(distribution.begin(), distribution.end(), 0));
-    return sum / distribution.size();
-}
+#include "src/util/ThreadPool.h"
+#include "src/util/Sketches.h"
+#include "src/features/Kernels.h"
 
+/**
+ * Streaming accumulator for the statistics of a distribution (mean, variance, min, max, entropy, quantiles)
+ * Sums are exact 64-bit integers for integral samples and compensated (Kahan) for floating point samples,
+ * the variance is calculated with Welford's method, and entropy is calculated over a histogram of
+ * the sample values (floating point samples are binned to one decimal place, NaN has a bin of its own).
+ * The histogram is dense for bins in [0, dense_bins) and sparse for all other bins, such that its size is bounded by
+ * dense_bins plus the number of distinct outlying bins (and not by the maximum value).
+ * Quantiles of integral samples are exact (read from the histogram), quantiles of floating point samples
+ * are exact up to QuantileSketch::exact_limit samples and have a relative error of at most QuantileSketch::accuracy
+ * otherwise, independent of the order of samples and merges.
+ * Accumulators of disjoint parts of a distribution can be merged.
+ */
 template <typename T>
-float Variance(std::vector<T> distribution, float mean) {
-    float sum = static_cast<float>(std::accumulate(distribution.begin(), distribution.end(), 0.0,
-        [mean] (float a, unsigned b) { return a + pow(static_cast<float>(b - mean), 2); } ));
-    return sum / distribution.size();
-}
+class Distribution {
+    typedef typename std::conditional<std::is_integral<T>::value, uint64_t, double>::type sum_t;
+
+    uint64_t n = 0;
+    sum_t sum = 0;
+    double compensation = 0;  // Kahan (unused for integral samples)
+    double mean_ = 0, m2 = 0;  // Welford
+    T min_ = T(), max_ = T();
+    std::vector<uint64_t> frequency;  // histogram for entropy (bins below dense_bins)
+    std::map<int64_t, uint64_t> outliers;  // histogram of negative bins and bins from dense_bins
+    QuantileSketch<T> sketch;  // quantiles (unused for integral samples)
 
-float Entropy(std::vector<unsigned> distribution) {
-    float entropy = 0;
-    std::vector<unsigned> frequency;
-    for (unsigned value : distribution) {
-        if (value >= frequency.size()) {
-            frequency.resize(value+1, 0);
+    static inline int64_t bin(T value) {
+        if (std::is_integral<T>::value) {
+            return static_cast<int64_t>(value);
+        } else if (std::isnan(static_cast<double>(value))) {
+            return INT64_MIN;
+        } else {  // clamped such that infinite values have bins, too
+            return static_cast<int64_t>(std::max<double>(-9e18, std::min<double>(9e18, std::round(10 * value))));
         }
-        ++frequency[value];
     }
-    for (unsigned freq : frequency) if (freq > 0) {
-        float p_x = static_cast<float>(freq) / distribution.size();
-        if (p_x > 0) entropy -= p_x * log(p_x) / log(2);
+
+    inline void count(int64_t item) {
+        if (item >= 0 && item < static_cast<int64_t>(dense_bins)) {
+            if (static_cast<size_t>(item) >= frequency.size()) {
+                frequency.resize(item + 1, 0);
+            }
+            ++frequency[item];
+        } else {
+            ++outliers[item];
+        }
+    }
+
+    inline void add_sum(sum_t value) {
+        if (std::is_integral<T>::value) {
+            sum += value;
+        } else {
+            double y = value - compensation;
+            double t = sum + y;
+            compensation = (t - sum) - y;
+            sum = t;
+        }
+    }
+
+ public:
+    static constexpr size_t dense_bins = 1 << 16;
+
+    Distribution() = default;
+
+    // From the statistics of n > 0 samples gathered elsewhere (sum of squared deviations m2 and histogram)
+    Distribution(uint64_t n, sum_t sum, double m2, T min, T max, std::vector<uint64_t> frequency) :
+        n(n), sum(sum), mean_(static_cast<double>(sum) / n), m2(m2), min_(min), max_(max), frequency(std::move(frequency)) {
+        assert(this->frequency.size() <= dense_bins);
+    }
+
+    inline void add(T value) {
+        if (n == 0 || value < min_) min_ = value;
+        if (n == 0 || value > max_) max_ = value;
+        ++n;
+        add_sum(static_cast<sum_t>(value));
+        double delta = static_cast<double>(value) - mean_;
+        mean_ += delta / n;
+        m2 += delta * (static_cast<double>(value) - mean_);
+        count(bin(value));
+        if (!std::is_integral<T>::value) {
+            sketch.add(value);
+        }
     }
-    return entropy;
-}
 
-float Entropy(std::vector<float> distribution) {
-    float entropy = 0;
-    std::vector<unsigned> frequency;
-    for (float value : distribution) {
-        unsigned item = static_cast<unsigned>(std::round(10 * value));
-        if (item >= frequency.size()) {
-            frequency.resize(item+1, 0);
+    void merge(const Distribution<T>& other) {
+        if (other.n == 0) return;
+        if (n == 0) {
+            *this = other;
+            return;
+        }
+        min_ = std::min(min_, other.min_);
+        max_ = std::max(max_, other.max_);
+        uint64_t total = n + other.n;
+        double delta = other.mean_ - mean_;
+        m2 += other.m2 + delta * delta * (static_cast<double>(n) * other.n / total);
+        mean_ += delta * other.n / total;
+        n = total;
+        add_sum(other.sum);
+        add_sum(static_cast<sum_t>(-other.compensation));
+        if (other.frequency.size() > frequency.size()) {
+            frequency.resize(other.frequency.size(), 0);
+        }
+        for (size_t i = 0; i < other.frequency.size(); i++) {
+            frequency[i] += other.frequency[i];
         }
-        ++frequency[item];
+        for (auto& outlier : other.outliers) {
+            outliers[outlier.first] += outlier.second;
+        }
+        sketch.merge(other.sketch);
+    }
+
+    inline uint64_t size() const {
+        return n;
     }
-    for (unsigned freq : frequency) if (freq > 0) {
-        float p_x = static_cast<float>(freq) / distribution.size();
-        if (p_x > 0) entropy -= p_x * log(p_x) / log(2);
+
+    // Number of histogram bins in memory
+    inline size_t bins() const {
+        return frequency.size() + outliers.size();
     }
-    return entropy;
+
+    float mean() const {
+        return n > 0 ? static_cast<float>(static_cast<double>(sum) / n) : 0;
+    }
+
+    float variance() const {
+        return n > 0 ? static_cast<float>(m2 / n) : 0;
+    }
+
+    float min() const {
+        return static_cast<float>(min_);
+    }
+
+    float max() const {
+        return static_cast<float>(max_);
+    }
+
+    float entropy() const {
+        double entropy = 0;
+        auto term = [this, &entropy] (uint64_t freq) {
+            double p_x = static_cast<double>(freq) / n;
+            entropy -= p_x * log(p_x) / log(2);
+        };
+        for (uint64_t freq : frequency) if (freq > 0) term(freq);
+        for (auto& outlier : outliers) term(outlier.second);
+        return static_cast<float>(entropy);
+    }
+
+    // Sample at index floor(q * (n - 1)) of the sorted samples
+    float quantile(double q) const {
+        if (n == 0) return 0;
+        if (!std::is_integral<T>::value) {
+            return static_cast<float>(sketch.quantile(q));
+        }
+        const uint64_t index = static_cast<uint64_t>(q * (n - 1) + 1e-9);
+        uint64_t count = 0;
+        auto large = outliers.lower_bound(0);
+        for (auto it = outliers.begin(); it != large; ++it) {
+            count += it->second;
+            if (count > index) return static_cast<float>(it->first);
+        }
+        for (size_t value = 0; value < frequency.size(); value++) {
+            count += frequency[value];
+            if (count > index) return static_cast<float>(value);
+        }
+        for (auto it = large; it != outliers.end(); ++it) {
+            count += it->second;
+            if (count > index) return static_cast<float>(it->first);
+        }
+        return max();
+    }
+
+    // Bound of the absolute error of quantile(q) (0 if exact)
+    double quantile_error(double q) const {
+        return std::is_integral<T>::value ? 0 : sketch.quantile_error(q);
+    }
+};
+
+template <typename T>
+void push_distribution(std::vector<float>* record, const Distribution<T>& distribution) {
+    record->push_back(distribution.mean());
+    record->push_back(distribution.variance());
+    record->push_back(distribution.min());
+    record->push_back(distribution.max());
+    record->push_back(distribution.entropy());
 }
 
+template <typename T>
+void push_distribution(std::vector<float>* record, const std::vector<T>& samples) {
+    Distribution<T> distribution;
+    for (T value : samples) distribution.add(value);
+    push_distribution(record, distribution);
+}
 
 template <typename T>
-void push_distribution(std::vector<float>* record, std::vector<T> distribution) {
-    float mean = 0, variance = 0, min = 0, max = 0, entropy = 0;
-    if (distribution.size() > 0) {
-        mean = Mean(distribution);
-        variance = Variance(distribution, mean);
-        min = static_cast<float>(*std::min_element(distribution.begin(), distribution.end()));
-        max = static_cast<float>(*std::max_element(distribution.begin(), distribution.end()));
-        entropy = Entropy(distribution);
-    }
-    record->push_back(mean);
-    record->push_back(variance);
-    record->push_back(min);
-    record->push_back(max);
-    record->push_back(entropy);
+void push_quantiles(std::vector<float>* record, const Distribution<T>& distribution) {
+    record->push_back(distribution.quantile(0.5));
+    record->push_back(distribution.quantile(0.9));
+    record->push_back(distribution.quantile(0.99));
+}
+
+// Feature names of the statistics pushed by push_distribution
+inline std::vector<std::string> distribution_names(const std::string& prefix) {
+    return std::vector<std::string> { prefix + "_mean", prefix + "_variance", prefix + "_min", prefix + "_max", prefix + "_entropy" };
+}
+
+// Feature names of the quantiles pushed by push_quantiles
+inline std::vector<std::string> quantile_names(const std::string& prefix) {
+    return std::vector<std::string> { prefix + "_median", prefix + "_p90", prefix + "_p99" };
+}
+
+// Counter arrays are summarized with the vectorized kernels (min, max and sum, then deviations and histogram)
+inline Distribution<unsigned> summarize(const std::vector<unsigned>& samples) {
+    if (samples.empty()) {
+        return Distribution<unsigned>();
+    }
+    MinMaxSum mms = min_max_sum(samples.data(), samples.size());
+    if (mms.max >= Distribution<unsigned>::dense_bins) {  // outliers go to the sparse histogram
+        Distribution<unsigned> distribution;
+        for (unsigned value : samples) distribution.add(value);
+        return distribution;
+    }
+    double m2 = squared_deviation(samples.data(), samples.size(), static_cast<double>(mms.sum) / samples.size());
+    std::vector<uint64_t> frequency;
+    count_frequencies(samples.data(), samples.size(), mms.max, &frequency);
+    return Distribution<unsigned>(samples.size(), mms.sum, m2, mms.min, mms.max, std::move(frequency));
+}
+
+inline void push_distribution(std::vector<float>* record, const std::vector<unsigned>& samples) {
+    push_distribution(record, summarize(samples));
+}
+
+/**
+ * Sums thread-local counter arrays into the first one (parallel over index ranges) and releases the others
+ */
+template <typename T>
+void reduce_counters(std::vector<std::vector<T>>* counters, unsigned threads) {
+    std::vector<T>& total = counters->front();
+    parallel_for(total.size(), threads, [counters, &total] (unsigned, size_t begin, size_t end) {
+        for (size_t k = 1; k < counters->size(); k++) {
+            const std::vector<T>& part = (*counters)[k];
+            for (size_t i = begin; i < end; i++) {
+                total[i] += part[i];
+            }
+        }
+    });
+    counters->resize(1);
 }
 
 #endif  // SRC_FEATURES_UTIL_H_
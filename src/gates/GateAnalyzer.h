@@ -69,7 +69,7 @@ class GateAnalyzer {
         if (semantic) ipasir_release(S);
     }
 
-    GateFormula getGateFormula() const {
+    const GateFormula& getGateFormula() const {
         return gate_formula;
     }
 
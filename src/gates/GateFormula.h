@@ -163,7 +163,7 @@ class GateFormula {
         return artificialRoot;
     }
 
-    std::vector<Lit> getRoots() {
+    std::vector<Lit> getRoots() const {
         std::vector<Lit> result;
         for (Cl* root : roots) {
             result.insert(result.end(), root->begin(), root->end());
@@ -20,33 +20,115 @@ OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWA
 #include "Python.h"
 
 #include "src/util/GBDHash.h"
+#include "src/util/HashCache.h"
+#include "src/util/InvariantHash.h"
+#include "src/util/WLFingerprint.h"
 #include "src/util/CNFFormula.h"
 #include "src/util/ResourceLimits.h"
 
 #include "src/features/CNFStats.h"
+#include "src/features/ApproxCNFStats.h"
 #include "src/features/GateStats.h"
 
 static PyObject* version(PyObject* self) {
     return Py_BuildValue("i", 1);
 }
 
+// hash cache of the most recently given cache file (kept open across calls)
+static std::unique_ptr<HashCache> hash_cache;
+static std::string hash_cache_path;
+
+static HashCache* get_hash_cache(const char* path) {
+    if (path == nullptr || *path == '\0') {
+        return nullptr;
+    }
+    if (!hash_cache || hash_cache_path != path) {
+        hash_cache.reset(new HashCache(path));
+        hash_cache_path = path;
+    }
+    return hash_cache.get();
+}
+
 static PyObject* gbdhash(PyObject* self, PyObject* arg) {
     const char* filename;
+    const char* cachefile = nullptr;
+
+    if (!PyArg_ParseTuple(arg, "s|z", &filename, &cachefile)) {
+        return nullptr;
+    }
+
+    std::string result = cached_hash(filename, get_hash_cache(cachefile), gbd_hash_from_dimacs);
+
+    return Py_BuildValue("s", result.c_str());
+}
+
+static PyObject* fasthash(PyObject* self, PyObject* arg) {
+    const char* filename;
+
+    if (!PyArg_ParseTuple(arg, "s", &filename)) {
+        return nullptr;
+    }
+
+    std::string result = fast_hash_from_dimacs(filename);
+
+    return Py_BuildValue("s", result.c_str());
+}
+
+static PyObject* identify(PyObject* self, PyObject* arg) {
+    const char* filename;
 
     if (!PyArg_ParseTuple(arg, "s", &filename)) {
         return nullptr;
     }
 
-    std::string result = gbd_hash_from_dimacs(filename);
+    std::pair<std::string, std::string> result = gbd_and_fast_hash_from_dimacs(filename);
+
+    return Py_BuildValue("{s:s,s:s}", "gbdhash", result.first.c_str(), "fasthash", result.second.c_str());
+}
+
+static PyObject* permhash(PyObject* self, PyObject* arg) {
+    const char* filename;
+    int renaming = 0;
+
+    if (!PyArg_ParseTuple(arg, "s|p", &filename, &renaming)) {
+        return nullptr;
+    }
+
+    std::string result = renaming ? renaming_invariant_hash_from_dimacs(filename) : permutation_invariant_hash_from_dimacs(filename);
 
     return Py_BuildValue("s", result.c_str());
 }
 
+static PyObject* wlhash(PyObject* self, PyObject* arg) {
+    const char* filename;
+    unsigned threads = 1;
+
+    if (!PyArg_ParseTuple(arg, "s|I", &filename, &threads)) {
+        return nullptr;
+    }
+
+    CNFFormula formula;
+    formula.readDimacsFromFile(filename);
+    ResourceLimits limits(0, 0);
+    WLFingerprint wl(formula, limits, threads);
+    wl.analyze();
+
+    return Py_BuildValue("{s:s,s:I}", "wl_fingerprint", wl.fingerprint().c_str(), "wl_rounds", wl.rounds());
+}
+
 static PyObject* extract_base_features(PyObject* self, PyObject* arg) {
     const char* filename;
-    unsigned rlim = 0, mlim = 0;
+    unsigned rlim = 0, mlim = 0, threads = 1;
+    const char* groups = "";
 
-    if (!PyArg_ParseTuple(arg, "s|II", &filename, &rlim, &mlim)) {
+    if (!PyArg_ParseTuple(arg, "s|IIIs", &filename, &rlim, &mlim, &threads, &groups)) {
+        return nullptr;
+    }
+
+    try {
+        CNFStats::parse_groups(groups);
+    } catch (std::invalid_argument& e) {
+        PyErr_SetString(PyExc_ValueError, e.what());
         return nullptr;
     }
 
@@ -57,21 +139,21 @@ static PyObject* extract_base_features(PyObject* self, PyObject* arg) {
     formula.readDimacsFromFile(filename);
     ResourceLimits limits(rlim, mlim);
 
-    CNFStats stats(formula, limits);
+    CNFStats stats(formula, limits, threads, groups);
+    bool exceeded = false, memout = false;
     try {
         limits.within_limits_or_throw();
         stats.analyze();
     } catch (ResourceLimitsExceeded& e) {
-        PyObject *key = Py_BuildValue("s", "base_features_runtime");
-        PyObject *val = Py_BuildValue("s", limits.within_memory_limit() ?  "timeout" : "memout");
-        PyDict_SetItem(dict, key, val);
-        return dict;
+        exceeded = true;
+        memout = !limits.within_memory_limit();
     } catch (std::bad_alloc& e) {
-        return dict;
+        exceeded = memout = true;
     }
 
+    // completed groups (all of them, or those finished before the limits were exceeded)
     std::vector<float> record = stats.BaseFeatures();
-    std::vector<std::string> names = CNFStats::BaseFeatureNames();
+    std::vector<std::string> names = stats.FeatureNames();
 
     for (unsigned int i = 0; i < record.size(); i++) {
         PyObject *key = Py_BuildValue("s", names[i].c_str());
@@ -82,6 +164,82 @@ static PyObject* extract_base_features(PyObject* self, PyObject* arg) {
         }
         PyDict_SetItem(dict, key, num);
     }
+
+    if (exceeded) {
+        PyObject *key = Py_BuildValue("s", "base_features_runtime");
+        PyObject *val = Py_BuildValue("s", memout ? "memout" : "timeout");
+        PyDict_SetItem(dict, key, val);
+        key = Py_BuildValue("s", "base_features_stopped_at");
+        val = Py_BuildValue("s", stats.StoppedAt().c_str());
+        PyDict_SetItem(dict, key, val);
+    }
+    return dict;
+}
+
+static PyObject* extract_approximate_base_features(PyObject* self, PyObject* arg) {
+    const char* filename;
+    unsigned rlim = 0, mlim = 0, sample = 1 << 16;
+    const char* groups = "";
+
+    if (!PyArg_ParseTuple(arg, "s|IIIs", &filename, &rlim, &mlim, &sample, &groups)) {
+        return nullptr;
+    }
+
+    try {
+        ApproxCNFStats::parse_groups(groups);
+    } catch (std::invalid_argument& e) {
+        PyErr_SetString(PyExc_ValueError, e.what());
+        return nullptr;
+    }
+
+    PyObject *dict = PyDict_New();
+    if (!dict) return nullptr;
+
+    ResourceLimits limits(rlim, mlim);
+    ApproxCNFStats stats(filename, limits, sample, groups);
+    bool exceeded = false, memout = false;
+    try {
+        limits.within_limits_or_throw();
+        stats.analyze();
+    } catch (ResourceLimitsExceeded& e) {
+        exceeded = true;
+        memout = !limits.within_memory_limit();
+    } catch (std::bad_alloc& e) {
+        exceeded = memout = true;
+    }
+
+    // completed groups (all of them, or those finished before the limits were exceeded)
+    std::vector<float> record = stats.BaseFeatures();
+    std::vector<float> errors = stats.BaseFeatureErrors();
+    std::vector<float> biases = stats.BaseFeatureBiases();
+    std::vector<std::string> names = stats.FeatureNames();
+
+    auto set_item = [dict] (const std::string& name, float value) {
+        PyObject *key = Py_BuildValue("s", name.c_str());
+        PyObject *num = PyFloat_FromDouble(static_cast<double>(value));
+        if (!num) return false;
+        PyDict_SetItem(dict, key, num);
+        return true;
+    };
+    for (unsigned int i = 0; i + 1 < record.size(); i++) {
+        if (!set_item(names[i], record[i]) || !set_item(names[i] + "_error", errors[i])
+         || (ApproxCNFStats::HasBias(names[i]) && !set_item(names[i] + "_bias", biases[i]))) {
+            Py_DECREF(dict);
+            return nullptr;
+        }
+    }
+
+    if (exceeded) {
+        PyObject *key = Py_BuildValue("s", "base_features_runtime");
+        PyObject *val = Py_BuildValue("s", memout ? "memout" : "timeout");
+        PyDict_SetItem(dict, key, val);
+        key = Py_BuildValue("s", "base_features_stopped_at");
+        val = Py_BuildValue("s", stats.StoppedAt().c_str());
+        PyDict_SetItem(dict, key, val);
+    } else if (!set_item(names.back(), record.back())) {
+        Py_DECREF(dict);
+        return nullptr;
+    }
     return dict;
 }
 
@@ -130,8 +288,13 @@ static PyObject* extract_gate_features(PyObject* self, PyObject* arg) {
 
 static PyMethodDef myMethods[] = {
     {"extract_gate_features", extract_gate_features, METH_VARARGS, "Extract Gate Features."},
-    {"extract_base_features", extract_base_features, METH_VARARGS, "Extract Base Features."},
-    {"gbdhash", gbdhash, METH_VARARGS, "Calculates GBD-Hash of given DIMACS CNF file."},
+    {"extract_base_features", extract_base_features, METH_VARARGS, "Extract Base Features (optional: time limit, memory limit, number of threads, comma-separated feature groups)."},
+    {"extract_approximate_base_features", extract_approximate_base_features, METH_VARARGS, "Extract Approximate Base Features with error estimates in bounded memory (optional: time limit, memory limit, sample size, comma-separated feature groups)."},
+    {"gbdhash", gbdhash, METH_VARARGS, "Calculates GBD-Hash of given DIMACS CNF file (optional: path of hash cache file)."},
+    {"fasthash", fasthash, METH_VARARGS, "Calculates fast secondary identifier (non-cryptographic 128-bit hash) of given DIMACS CNF file."},
+    {"permhash", permhash, METH_VARARGS, "Calculates hash of given DIMACS CNF file which is invariant under clause and literal order (optional: also under variable renaming)."},
+    {"wlhash", wlhash, METH_VARARGS, "Calculates Weisfeiler-Lehman fingerprint of the literal-clause graph of given DIMACS CNF file and number of rounds to stability (optional: number of threads)."},
+    {"identify", identify, METH_VARARGS, "Calculates GBD-Hash and fast secondary identifier of given DIMACS CNF file in one pass."},
     {"version", (PyCFunction)version, METH_NOARGS, "Returns Version"},
     {nullptr, nullptr, 0, nullptr}
 };
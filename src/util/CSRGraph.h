@@ -0,0 +1,221 @@
+/*************************************************************************************************
+CNFTools -- Copyright (c) 2021, Markus Iser, KIT - Karlsruhe Institute of Technology
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT
+OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ **************************************************************************************************/
+
+#ifndef SRC_UTIL_CSRGRAPH_H_
+#define SRC_UTIL_CSRGRAPH_H_
+
+#include <cstdint>
+#include <vector>
+#include <algorithm>
+
+#include "src/util/SolverTypes.h"
+#include "src/util/CNFFormula.h"
+#include "src/util/ResourceLimits.h"
+#include "src/util/ThreadPool.h"
+
+/**
+ * Graph in compressed sparse row format: the neighbours of vertex v are targets[offsets[v] .. offsets[v + 1]),
+ * sorted by vertex index and without duplicates (a self loop is a neighbour v of v)
+ */
+class CSRGraph {
+ public:
+    std::vector<uint64_t> offsets;
+    std::vector<unsigned> targets;
+    std::vector<float> weights;  // edge weights aligned with targets (empty for unweighted graphs)
+
+    CSRGraph() : offsets(1, 0), targets(), weights() { }
+
+    inline size_t size() const {
+        return offsets.size() - 1;
+    }
+
+    inline uint64_t edges() const {
+        return targets.size();
+    }
+
+    inline unsigned degree(unsigned v) const {
+        return static_cast<unsigned>(offsets[v + 1] - offsets[v]);
+    }
+
+    inline const unsigned* begin(unsigned v) const {
+        return targets.data() + offsets[v];
+    }
+
+    inline const unsigned* end(unsigned v) const {
+        return targets.data() + offsets[v + 1];
+    }
+
+    inline bool adjacent(unsigned u, unsigned v) const {
+        if (degree(u) > degree(v)) std::swap(u, v);
+        return std::binary_search(begin(u), end(u), v);
+    }
+
+    /**
+     * Builds a graph with n vertices in parallel, where row(thread, v, &targets) appends the neighbours of v
+     * (in any order, duplicates are allowed). Throws ResourceLimitsExceeded if the limits are exceeded.
+     */
+    template <typename Row>
+    static CSRGraph build(size_t n, unsigned threads, const ResourceLimits& limits, Row row) {
+        threads = std::min<size_t>(ThreadPool::resolve(threads), std::max<size_t>(n, 1));
+        CSRGraph graph;
+        graph.offsets.assign(n + 1, 0);
+        std::vector<std::vector<unsigned>> parts(threads);
+        std::vector<size_t> first(threads, n);
+        for_each_chunk(n, threads, limits, [&] (unsigned t, size_t begin, size_t end) {
+            std::vector<unsigned>& part = parts[t];
+            first[t] = std::min(first[t], begin);
+            for (size_t v = begin; v < end; v++) {
+                size_t start = part.size();
+                row(t, v, &part);
+                std::sort(part.begin() + start, part.end());
+                part.erase(std::unique(part.begin() + start, part.end()), part.end());
+                graph.offsets[v + 1] = part.size() - start;
+            }
+        }, 1 << 12);
+        for (size_t v = 0; v < n; v++) {
+            graph.offsets[v + 1] += graph.offsets[v];
+        }
+        graph.targets.resize(graph.offsets[n]);
+        parallel_for(threads, threads, [&] (unsigned, size_t begin, size_t end) {
+            for (size_t t = begin; t < end; t++) if (!parts[t].empty()) {
+                std::copy(parts[t].begin(), parts[t].end(), graph.targets.begin() + graph.offsets[first[t]]);
+                std::vector<unsigned>().swap(parts[t]);
+            }
+        });
+        return graph;
+    }
+
+    /**
+     * Sets the edge weights in parallel, where contributions(thread, v, add) calls add(w, weight)
+     * for neighbours w of v (several contributions to the same edge are summed up)
+     */
+    template <typename Contributions>
+    void set_weights(unsigned threads, const ResourceLimits& limits, Contributions contributions) {
+        weights.assign(targets.size(), 0);
+        std::vector<std::vector<uint64_t>> positions(ThreadPool::resolve(threads));  // of the neighbours of v
+        for_each_chunk(size(), threads, limits, [&] (unsigned t, size_t begin, size_t end) {
+            std::vector<uint64_t>& position = positions[t];
+            if (position.empty()) position.resize(size(), 0);
+            for (size_t v = begin; v < end; v++) {
+                for (uint64_t i = offsets[v]; i < offsets[v + 1]; i++) {
+                    position[targets[i]] = i;
+                }
+                contributions(t, v, [&] (unsigned w, float weight) { weights[position[w]] += weight; });
+            }
+        }, 1 << 12);
+    }
+
+    /**
+     * Occurrence lists: indices of the clauses which contain variable v in occurrences[offsets[v] .. offsets[v + 1])
+     */
+    static void variable_occurrences(const CNFFormula& formula, std::vector<uint64_t>* offsets, std::vector<unsigned>* occurrences) {
+        const size_t n = formula.nVars() + 1;
+        offsets->assign(n + 1, 0);
+        for (const Cl* clause : formula) {
+            for (Lit lit : *clause) ++(*offsets)[lit.var() + 1];
+        }
+        for (size_t v = 0; v < n; v++) {
+            (*offsets)[v + 1] += (*offsets)[v];
+        }
+        occurrences->resize((*offsets)[n]);
+        std::vector<uint64_t> fill(offsets->begin(), offsets->end() - 1);
+        unsigned index = 0;
+        for (const Cl* clause : formula) {
+            for (Lit lit : *clause) (*occurrences)[fill[lit.var()]++] = index;
+            ++index;
+        }
+    }
+
+    /**
+     * Variable incidence graph: vertices are variables (0 is unused), two variables are adjacent
+     * if they occur together in a clause. If weighted, each clause c adds 1 / (|c| choose 2) to the weight
+     * of each pair of its variables (such that each clause of size > 1 contributes weight 1).
+     */
+    static CSRGraph VariableIncidenceGraph(const CNFFormula& formula, unsigned threads, const ResourceLimits& limits, bool weighted = false) {
+        const size_t n = formula.nVars() + 1;
+        std::vector<uint64_t> occ_offsets;
+        std::vector<unsigned> occurrences;
+        variable_occurrences(formula, &occ_offsets, &occurrences);
+        limits.within_limits_or_throw();
+
+        std::vector<std::vector<unsigned>> stamps(ThreadPool::resolve(threads));  // last vertex (+1) which added a neighbour
+        CSRGraph graph = build(n, threads, limits, [&] (unsigned t, size_t v, std::vector<unsigned>* row) {
+            std::vector<unsigned>& stamp = stamps[t];
+            if (stamp.empty()) stamp.resize(n, 0);
+            for (uint64_t i = occ_offsets[v]; i < occ_offsets[v + 1]; i++) {
+                for (Lit lit : *formula[occurrences[i]]) {
+                    unsigned w = lit.var();
+                    if (w != v && stamp[w] != v + 1) {
+                        stamp[w] = v + 1;
+                        row->push_back(w);
+                    }
+                }
+            }
+        });
+        if (weighted) {
+            graph.set_weights(threads, limits, [&] (unsigned, size_t v, auto add) {
+                for (uint64_t i = occ_offsets[v]; i < occ_offsets[v + 1]; i++) {
+                    const Cl* clause = formula[occurrences[i]];
+                    if (clause->size() < 2) continue;
+                    const float weight = 2.0 / (clause->size() * (clause->size() - 1.0));
+                    for (Lit lit : *clause) {
+                        unsigned w = lit.var();
+                        if (w != v) add(w, weight);
+                    }
+                }
+            });
+        }
+        return graph;
+    }
+
+    /**
+     * Variable clause graph: bipartite graph with vertices 0 .. n for the variables (0 is unused) and n + 1 + c
+     * for clause c, where a variable is adjacent to the clauses in which it occurs
+     */
+    static CSRGraph VariableClauseGraph(const CNFFormula& formula, unsigned threads, const ResourceLimits& limits) {
+        const size_t n = formula.nVars() + 1;
+        std::vector<uint64_t> occ_offsets;
+        std::vector<unsigned> occurrences;
+        variable_occurrences(formula, &occ_offsets, &occurrences);
+        limits.within_limits_or_throw();
+        return build(n + formula.nClauses(), threads, limits, [&] (unsigned, size_t v, std::vector<unsigned>* row) {
+            if (v < n) {
+                for (uint64_t i = occ_offsets[v]; i < occ_offsets[v + 1]; i++) row->push_back(n + occurrences[i]);
+            } else {
+                for (Lit lit : *formula[v - n]) row->push_back(lit.var());
+            }
+        });
+    }
+
+    /**
+     * Degree ordering: keeps each edge only at its endpoint of lower rank, where vertices are ranked by degree
+     * and then by index, such that every vertex keeps at most sqrt(2m) neighbours
+     */
+    CSRGraph oriented(unsigned threads, const ResourceLimits& limits) const {
+        return build(size(), threads, limits, [this] (unsigned, size_t v, std::vector<unsigned>* row) {
+            const unsigned dv = degree(v);
+            for (const unsigned* w = begin(v); w != end(v); ++w) {
+                const unsigned dw = degree(*w);
+                if (dv < dw || (dv == dw && v < *w)) row->push_back(*w);
+            }
+        });
+    }
+};
+
+#endif  // SRC_UTIL_CSRGRAPH_H_
@@ -0,0 +1,172 @@
+/*************************************************************************************************
+CNFTools -- Copyright (c) 2021, Markus Iser, KIT - Karlsruhe Institute of Technology
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT
+OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ **************************************************************************************************/
+
+#ifndef SRC_UTIL_FASTHASH_H_
+#define SRC_UTIL_FASTHASH_H_
+
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+#include <array>
+#include <string>
+
+// pseudo-random key material (splitmix64)
+template <unsigned N>
+constexpr std::array<uint64_t, N> fast_hash_secret() {
+    std::array<uint64_t, N> secret {};
+    uint64_t x = 0x2F8A5C31E0D6B947ull;
+    for (unsigned i = 0; i < N; i++) {
+        uint64_t z = (x += 0x9E3779B97F4A7C15ull);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        secret[i] = z ^ (z >> 31);
+    }
+    return secret;
+}
+
+/**
+ * Fast non-cryptographic 128-bit streaming hash in the style of XXH3:
+ * 64-byte stripes are accumulated into eight 64-bit lanes (32x32->64 bit multiply),
+ * and lanes are scrambled after every block of 16 stripes.
+ * Note: Results are not compatible with the reference XXH3 implementation.
+ */
+class FastHash128 {
+    static constexpr unsigned stripe_size = 64;
+    static constexpr unsigned stripes_per_block = 16;
+    static constexpr unsigned secret_size = 8 + stripes_per_block + 8;
+
+    static constexpr uint64_t PRIME32_1 = 0x9E3779B1ull;
+    static constexpr uint64_t PRIME64_1 = 0x9E3779B185EBCA87ull;
+    static constexpr uint64_t PRIME64_2 = 0xC2B2AE3D27D4EB4Full;
+    static constexpr uint64_t PRIME64_3 = 0x165667B19E3779F9ull;
+
+    static constexpr std::array<uint64_t, secret_size> secret = fast_hash_secret<secret_size>();
+
+    uint64_t acc[8];
+    unsigned char pending[stripe_size];
+    unsigned n_pending;
+    unsigned n_stripes;  // stripes in current block
+    uint64_t length;
+
+    static inline uint64_t read64(const unsigned char* p) {
+        uint64_t value;
+        memcpy(&value, p, sizeof(value));
+        return value;
+    }
+
+    static inline uint64_t avalanche(uint64_t h) {
+        h ^= h >> 37;
+        h *= PRIME64_3;
+        return h ^ (h >> 32);
+    }
+
+    // fold 128-bit product
+    static inline uint64_t mix(uint64_t a, uint64_t b) {
+    #if defined(__SIZEOF_INT128__)
+        __uint128_t product = static_cast<__uint128_t>(a) * b;
+        return static_cast<uint64_t>(product) ^ static_cast<uint64_t>(product >> 64);
+    #else
+        uint64_t lo_lo = (a & 0xFFFFFFFF) * (b & 0xFFFFFFFF);
+        uint64_t hi_lo = (a >> 32) * (b & 0xFFFFFFFF);
+        uint64_t lo_hi = (a & 0xFFFFFFFF) * (b >> 32);
+        uint64_t hi_hi = (a >> 32) * (b >> 32);
+        uint64_t cross = (lo_lo >> 32) + (hi_lo & 0xFFFFFFFF) + lo_hi;
+        uint64_t upper = (hi_lo >> 32) + (cross >> 32) + hi_hi;
+        uint64_t lower = (cross << 32) | (lo_lo & 0xFFFFFFFF);
+        return lower ^ upper;
+    #endif
+    }
+
+    inline void accumulate(const unsigned char* stripe, const uint64_t* key) {
+        for (unsigned i = 0; i < 8; i++) {
+            uint64_t value = read64(stripe + 8*i);
+            uint64_t keyed = value ^ key[i];
+            acc[i ^ 1] += value;
+            acc[i] += (keyed & 0xFFFFFFFFull) * (keyed >> 32);
+        }
+        if (++n_stripes == stripes_per_block) {
+            for (unsigned i = 0; i < 8; i++) {
+                acc[i] ^= acc[i] >> 47;
+                acc[i] ^= secret[secret_size - 8 + i];
+                acc[i] *= PRIME32_1;
+            }
+            n_stripes = 0;
+        }
+    }
+
+    inline void accumulate(const unsigned char* stripe) {
+        accumulate(stripe, secret.data() + n_stripes);
+    }
+
+ public:
+    FastHash128() : n_pending(0), n_stripes(0), length(0) {
+        acc[0] = PRIME32_1; acc[1] = PRIME64_1; acc[2] = PRIME64_2; acc[3] = PRIME64_3;
+        acc[4] = ~PRIME32_1; acc[5] = ~PRIME64_1; acc[6] = ~PRIME64_2; acc[7] = ~PRIME64_3;
+    }
+
+    void process(const void* input, unsigned input_length) {
+        const unsigned char* data = static_cast<const unsigned char*>(input);
+        length += input_length;
+        if (n_pending > 0) {
+            unsigned fill = std::min(input_length, stripe_size - n_pending);
+            memcpy(pending + n_pending, data, fill);
+            n_pending += fill;
+            data += fill;
+            input_length -= fill;
+            if (n_pending < stripe_size) return;
+            accumulate(pending);
+            n_pending = 0;
+        }
+        while (input_length >= stripe_size) {
+            accumulate(data);
+            data += stripe_size;
+            input_length -= stripe_size;
+        }
+        memcpy(pending, data, input_length);
+        n_pending = input_length;
+    }
+
+    // 128-bit digest as pair (high, low)
+    std::pair<uint64_t, uint64_t> finish() {
+        if (n_pending > 0) {
+            memset(pending + n_pending, 0, stripe_size - n_pending);
+            accumulate(pending, secret.data() + stripes_per_block);
+            n_pending = 0;
+        }
+        uint64_t low = length * PRIME64_1;
+        uint64_t high = ~length * PRIME64_2;
+        for (unsigned i = 0; i < 8; i += 2) {
+            low += mix(acc[i] ^ secret[i], acc[i+1] ^ secret[i+1]);
+            high += mix(acc[i] ^ secret[i+8], acc[i+1] ^ secret[i+9]);
+        }
+        return std::make_pair(avalanche(high), avalanche(low));
+    }
+
+    static std::string to_string(std::pair<uint64_t, uint64_t> digest) {
+        static const char* hex = "0123456789abcdef";
+        std::string str(32, '0');
+        for (unsigned i = 0; i < 16; i++) {
+            str[15 - i] = hex[(digest.first >> (4*i)) & 0xF];
+            str[31 - i] = hex[(digest.second >> (4*i)) & 0xF];
+        }
+        return str;
+    }
+};
+
+#endif  // SRC_UTIL_FASTHASH_H_
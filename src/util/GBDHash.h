@@ -21,17 +21,62 @@ OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWA
 #define SRC_UTIL_GBDHASH_H_
 
 #include <string>
+#include <charconv>
+#include <utility>
+#include <memory>
+#include <vector>
 
 #include "lib/md5/md5.h"
 
 #include "src/util/StreamBuffer.h"
+#include "src/util/FastHash.h"
+#include "src/util/MD5Lanes.h"
 
-std::string gbd_hash_from_dimacs(const char* filename) {
-    unsigned char sig[MD5_SIZE];
-    char str[MD5_STRING_SIZE];
-    md5::md5_t md5;
+/**
+ * Normalized clause text (e.g. "1 -2 0 3 0") is staged in a fixed buffer
+ * and handed to the digest in large blocks instead of one small call per clause
+ */
+template <class Digest>
+class NormalizedDimacsBuffer {
+    static constexpr unsigned buffer_size = 1 << 16;
+    static constexpr unsigned max_clause_item = 16;  // space for " -2147483648 "
+
+    Digest& digest;
+    char buffer[buffer_size];
+    unsigned pos = 0;
+
+ public:
+    explicit NormalizedDimacsBuffer(Digest& digest_) : digest(digest_) { }
+
+    ~NormalizedDimacsBuffer() {
+        flush();
+    }
+
+    inline void flush() {
+        if (pos > 0) digest.process(buffer, pos);
+        pos = 0;
+    }
+
+    inline void append(char c) {
+        if (pos == buffer_size) flush();
+        buffer[pos++] = c;
+    }
+
+    inline void append(int value) {
+        if (pos + max_clause_item > buffer_size) flush();
+        pos = std::to_chars(buffer + pos, buffer + buffer_size, value).ptr - buffer;
+    }
+};
+
+/**
+ * Feeds the normalized text of all clauses in the given file to the digest,
+ * i.e., without header and comments, clauses separated by a single space
+ */
+template <class Digest>
+void normalized_dimacs(const char* filename, Digest& digest) {
+    NormalizedDimacsBuffer<Digest> out(digest);
     StreamBuffer in(filename);
-    std::string clause("");
+    bool first = true;
     while (!in.eof()) {
         in.skipWhitespace();
         if (in.eof()) {
@@ -40,18 +85,208 @@ std::string gbd_hash_from_dimacs(const char* filename) {
         if (*in == 'p' || *in == 'c') {
             in.skipLine();
         } else {
+            if (!first) out.append(' ');
             for (int plit = in.readInteger(); plit != 0; plit = in.readInteger()) {
-                clause.append(std::to_string(plit));
-                clause.append(" ");
+                out.append(plit);
+                out.append(' ');
             }
-            clause.append("0");
-            md5.process(clause.c_str(), clause.length());
-            clause.assign(" ");
+            out.append('0');
+            first = false;
         }
     }
+}
+
+// Feeds the same input to two digests
+template <class DigestA, class DigestB>
+struct DigestPair {
+    DigestA& a;
+    DigestB& b;
+
+    inline void process(const void* input, unsigned input_length) {
+        a.process(input, input_length);
+        b.process(input, input_length);
+    }
+};
+
+std::string md5_string(md5::md5_t& md5) {
+    unsigned char sig[MD5_SIZE];
+    char str[MD5_STRING_SIZE];
     md5.finish(sig);
     md5::sig_to_string(sig, str, sizeof(str));
     return std::string(str);
 }
 
+std::string gbd_hash_from_dimacs(const char* filename) {
+    md5::md5_t md5;
+    normalized_dimacs(filename, md5);
+    return md5_string(md5);
+}
+
+/**
+ * Fast secondary identifier: 128-bit non-cryptographic hash over the same normalized clause text as the GBD hash
+ */
+std::string fast_hash_from_dimacs(const char* filename) {
+    FastHash128 fast;
+    normalized_dimacs(filename, fast);
+    return FastHash128::to_string(fast.finish());
+}
+
+// GBD hash and fast secondary identifier (in this order) computed in one pass
+std::pair<std::string, std::string> gbd_and_fast_hash_from_dimacs(const char* filename) {
+    md5::md5_t md5;
+    FastHash128 fast;
+    DigestPair<md5::md5_t, FastHash128> both { md5, fast };
+    normalized_dimacs(filename, both);
+    return std::make_pair(md5_string(md5), FastHash128::to_string(fast.finish()));
+}
+
+/**
+ * Pull-style variant of normalized_dimacs: produces the normalized clause text of the given file in chunks
+ */
+class NormalizedDimacsReader {
+    StreamBuffer in;
+    bool first = true;
+    bool in_clause = false;
+    bool eof_ = false;
+
+ public:
+    explicit NormalizedDimacsReader(const char* filename) : in(filename) { }
+
+    /**
+     * Write up to capacity bytes of normalized text to out (at least capacity - 16 unless the end of file is reached)
+     * @return number of bytes written
+     */
+    unsigned read(char* out, unsigned capacity) {
+        unsigned n = 0;
+        while (!eof_ && n + 16 <= capacity) {
+            if (!in_clause) {
+                in.skipWhitespace();
+                if (in.eof()) {
+                    eof_ = true;
+                    break;
+                }
+                if (*in == 'p' || *in == 'c') {
+                    in.skipLine();
+                    continue;
+                }
+                if (!first) out[n++] = ' ';
+                first = false;
+                in_clause = true;
+            }
+            int plit = in.readInteger();
+            if (plit == 0) {
+                out[n++] = '0';
+                in_clause = false;
+            } else {
+                n = std::to_chars(out + n, out + capacity, plit).ptr - out;
+                out[n++] = ' ';
+            }
+        }
+        return n;
+    }
+
+    bool eof() const {
+        return eof_;
+    }
+};
+
+/**
+ * Batch hashing engine for many (small) files: MD5 of up to eight files is computed in parallel lanes (MD5Lanes),
+ * each lane streams the normalized text of one file and takes the next file when done.
+ * Results are identical to gbd_hash_from_dimacs and reported per input index via on_result(index, hash),
+ * files which fail to open or parse are reported via on_error(index, message).
+ */
+template <typename ResultCallback, typename ErrorCallback>
+void gbd_hash_from_dimacs_lanes(const std::vector<std::string>& files, ResultCallback on_result, ErrorCallback on_error) {
+    static constexpr unsigned staging = 1 << 12;
+
+    struct Lane {
+        std::unique_ptr<NormalizedDimacsReader> reader;
+        size_t file = 0;
+        unsigned char buffer[staging + 2 * md5::BLOCK_SIZE];
+        unsigned pos = 0, end = 0;
+        uint64_t length = 0;
+        bool padded = false;
+    };
+
+    MD5Lanes md5;
+    std::vector<Lane> lanes(MD5Lanes::lanes);
+    size_t next_file = 0;
+
+    // load next file into lane (reader is null if no files are left)
+    auto assign = [&] (unsigned l) {
+        Lane& lane = lanes[l];
+        lane.reader.reset();
+        while (next_file < files.size() && !lane.reader) {
+            lane.file = next_file++;
+            try {
+                lane.reader.reset(new NormalizedDimacsReader(files[lane.file].c_str()));
+            } catch (std::exception& e) {
+                on_error(lane.file, std::string(e.what()));
+            }
+        }
+        lane.pos = lane.end = 0;
+        lane.length = 0;
+        lane.padded = false;
+        md5.reset(l);
+    };
+
+    // ensure that lane has at least one block, append md5 padding at end of file
+    auto refill = [&] (Lane& lane) {
+        if (lane.end - lane.pos >= md5::BLOCK_SIZE || lane.padded) return;
+        std::copy(lane.buffer + lane.pos, lane.buffer + lane.end, lane.buffer);
+        lane.end -= lane.pos;
+        lane.pos = 0;
+        while (lane.end < md5::BLOCK_SIZE && !lane.reader->eof()) {
+            unsigned n = lane.reader->read(reinterpret_cast<char*>(lane.buffer) + lane.end, staging - lane.end);
+            lane.end += n;
+            lane.length += n;
+        }
+        if (lane.end < md5::BLOCK_SIZE) {
+            uint64_t bits = lane.length << 3;
+            lane.buffer[lane.end++] = 0x80;
+            while (lane.end % md5::BLOCK_SIZE != md5::BLOCK_SIZE - 8) lane.buffer[lane.end++] = 0;
+            for (unsigned i = 0; i < 8; i++) lane.buffer[lane.end++] = static_cast<unsigned char>(bits >> (8*i));
+            lane.padded = true;
+        }
+    };
+
+    for (unsigned l = 0; l < MD5Lanes::lanes; l++) assign(l);
+
+    const unsigned char* blocks[MD5Lanes::lanes];
+    while (true) {
+        bool active = false;
+        for (unsigned l = 0; l < MD5Lanes::lanes; l++) {
+            Lane& lane = lanes[l];
+            blocks[l] = nullptr;
+            while (lane.reader) {
+                try {
+                    refill(lane);
+                    blocks[l] = lane.buffer + lane.pos;
+                    active = true;
+                    break;
+                } catch (std::exception& e) {
+                    on_error(lane.file, std::string(e.what()));
+                    assign(l);
+                }
+            }
+        }
+        if (!active) break;
+        md5.process(blocks);
+        for (unsigned l = 0; l < MD5Lanes::lanes; l++) {
+            Lane& lane = lanes[l];
+            if (blocks[l] == nullptr) continue;
+            lane.pos += md5::BLOCK_SIZE;
+            if (lane.padded && lane.pos == lane.end) {
+                unsigned char sig[MD5_SIZE];
+                char str[MD5_STRING_SIZE];
+                md5.digest(l, sig);
+                md5::sig_to_string(sig, str, sizeof(str));
+                on_result(lane.file, std::string(str));
+                assign(l);
+            }
+        }
+    }
+}
+
 #endif  // SRC_UTIL_GBDHASH_H_
@@ -0,0 +1,219 @@
+/*************************************************************************************************
+CNFTools -- Copyright (c) 2021, Markus Iser, KIT - Karlsruhe Institute of Technology
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT
+OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ **************************************************************************************************/
+
+#ifndef SRC_UTIL_HASHBATCH_H_
+#define SRC_UTIL_HASHBATCH_H_
+
+#include <iostream>
+#include <fstream>
+#include <atomic>
+#include <filesystem>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "src/util/GBDHash.h"
+#include "src/util/HashCache.h"
+#include "src/util/ThreadPool.h"
+
+/**
+ * Calls visit(path) for each given input: directories are searched recursively for regular files,
+ * and "-" reads a newline-separated list of paths from stdin
+ */
+template <typename Visitor>
+void for_each_input_path(const std::vector<std::string>& inputs, Visitor visit) {
+    namespace fs = std::filesystem;
+    for (const std::string& input : inputs) {
+        if (input == "-") {
+            std::string line;
+            while (std::getline(std::cin, line)) {
+                if (!line.empty()) visit(line);
+            }
+        } else if (fs::is_directory(input)) {
+            for (const fs::directory_entry& entry : fs::recursive_directory_iterator(input, fs::directory_options::skip_permission_denied)) {
+                if (entry.is_regular_file()) visit(entry.path().string());
+            }
+        } else {
+            visit(input);
+        }
+    }
+}
+
+/**
+ * Hash all given inputs with hash_function on a pool of worker threads
+ * Writes one line "hash<TAB>path" per file in order of completion, failures are reported to stderr
+ * Files which are unchanged according to the given cache (optional) are not read
+ * @return number of files which could not be hashed
+ */
+template <typename HashFunction>
+unsigned hash_batch(const std::vector<std::string>& inputs, unsigned threads, std::ostream& out, HashFunction hash_function, HashCache* cache = nullptr) {
+    std::mutex out_mutex;
+    unsigned failed = 0;
+    {
+        ThreadPool pool(threads);
+        for_each_input_path(inputs, [&] (const std::string& path) {
+            pool.submit([&, path] () {
+                try {
+                    std::string hash = cached_hash(path.c_str(), cache, hash_function);
+                    std::lock_guard<std::mutex> lock(out_mutex);
+                    out << hash << '\t' << path << '\n';
+                } catch (std::exception& e) {
+                    std::lock_guard<std::mutex> lock(out_mutex);
+                    std::cerr << path << ": " << e.what() << std::endl;
+                    ++failed;
+                }
+            });
+        });
+        pool.join();
+    }
+    out.flush();
+    return failed;
+}
+
+/**
+ * Variant of hash_batch for GBD hashes based on the multi-buffer md5 engine (gbd_hash_from_dimacs_lanes):
+ * inputs are grouped, and each worker hashes one group of files at a time in parallel md5 lanes
+ */
+unsigned gbd_hash_batch_lanes(const std::vector<std::string>& inputs, unsigned threads, std::ostream& out, HashCache* cache = nullptr) {
+    static constexpr unsigned group_size = 8 * MD5Lanes::lanes;
+    std::mutex out_mutex;
+    unsigned failed = 0;
+
+    auto hash_group = [&] (const std::vector<std::string>& group) {
+        std::vector<std::string> paths;
+        std::vector<FileKey> keys;
+        for (const std::string& path : group) {
+            FileKey key;
+            std::string hash;
+            if (cache != nullptr && FileKey::of(path.c_str(), &key) && cache->lookup(key, &hash)) {
+                std::lock_guard<std::mutex> lock(out_mutex);
+                out << hash << '\t' << path << '\n';
+            } else {
+                paths.push_back(path);
+                keys.push_back(key);
+            }
+        }
+        gbd_hash_from_dimacs_lanes(paths, [&] (size_t i, const std::string& hash) {
+            FileKey after;
+            if (cache != nullptr && FileKey::of(paths[i].c_str(), &after) && after == keys[i]) {
+                cache->insert(keys[i], hash);
+            }
+            std::lock_guard<std::mutex> lock(out_mutex);
+            out << hash << '\t' << paths[i] << '\n';
+        }, [&] (size_t i, const std::string& what) {
+            std::lock_guard<std::mutex> lock(out_mutex);
+            std::cerr << paths[i] << ": " << what << std::endl;
+            ++failed;
+        });
+    };
+
+    {
+        ThreadPool pool(threads);
+        std::vector<std::string> group;
+        for_each_input_path(inputs, [&] (const std::string& path) {
+            group.push_back(path);
+            if (group.size() == group_size) {
+                pool.submit([group, &hash_group] () { hash_group(group); });
+                group.clear();
+            }
+        });
+        if (!group.empty()) {
+            pool.submit([group, &hash_group] () { hash_group(group); });
+        }
+        pool.join();
+    }
+    out.flush();
+    return failed;
+}
+
+struct VerifyResult {
+    unsigned checked = 0;
+    unsigned mismatched = 0;
+    unsigned missing = 0;
+    unsigned failed = 0;  // unreadable files
+    unsigned malformed = 0;  // manifest lines without hash or path
+
+    bool ok() const {
+        return mismatched == 0 && missing == 0 && failed == 0 && malformed == 0;
+    }
+};
+
+/**
+ * Verify a manifest with lines "hash path" (or "hash<TAB>path" as written by batch hashing) against the GBD hashes
+ * of the files, hashing on a pool of worker threads. The manifest is streamed through a bounded queue.
+ * Windows line endings are accepted, blank lines and lines starting with '#' are skipped.
+ * Only problems are reported: "MISMATCH expected actual path", "MISSING path", "ERROR path: message"
+ * and "MALFORMED line: text" (for lines without hash or path)
+ */
+VerifyResult verify_manifest(std::istream& manifest, unsigned threads, std::ostream& out) {
+    std::mutex out_mutex;
+    std::atomic<unsigned> checked(0), mismatched(0), missing(0), failed(0), malformed(0);
+    {
+        ThreadPool pool(threads);
+        std::string line;
+        unsigned number = 0;
+        while (std::getline(manifest, line)) {
+            ++number;
+            if (!line.empty() && line.back() == '\r') line.pop_back();
+            if (line.find_first_not_of(" \t") == std::string::npos || line[0] == '#') continue;
+            size_t hash_end = line.find_first_of(" \t");
+            size_t path_begin = line.find_first_not_of(" \t", hash_end);
+            if (hash_end == 0 || path_begin == std::string::npos) {
+                ++malformed;
+                std::lock_guard<std::mutex> lock(out_mutex);
+                out << "MALFORMED " << number << ": " << line << '\n';
+                continue;
+            }
+            std::string expected = line.substr(0, hash_end);
+            std::string path = line.substr(path_begin);
+            pool.submit([&, expected, path] () {
+                ++checked;
+                if (!std::filesystem::exists(path)) {
+                    ++missing;
+                    std::lock_guard<std::mutex> lock(out_mutex);
+                    out << "MISSING " << path << '\n';
+                    return;
+                }
+                try {
+                    std::string actual = gbd_hash_from_dimacs(path.c_str());
+                    if (actual != expected) {
+                        ++mismatched;
+                        std::lock_guard<std::mutex> lock(out_mutex);
+                        out << "MISMATCH " << expected << " " << actual << " " << path << '\n';
+                    }
+                } catch (std::exception& e) {
+                    ++failed;
+                    std::lock_guard<std::mutex> lock(out_mutex);
+                    out << "ERROR " << path << ": " << e.what() << '\n';
+                }
+            });
+        }
+        pool.join();
+    }
+    out.flush();
+    VerifyResult result;
+    result.checked = checked;
+    result.mismatched = mismatched;
+    result.missing = missing;
+    result.failed = failed;
+    result.malformed = malformed;
+    return result;
+}
+
+#endif  // SRC_UTIL_HASHBATCH_H_
@@ -0,0 +1,177 @@
+/*************************************************************************************************
+CNFTools -- Copyright (c) 2021, Markus Iser, KIT - Karlsruhe Institute of Technology
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT
+OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ **************************************************************************************************/
+
+#ifndef SRC_UTIL_HASHCACHE_H_
+#define SRC_UTIL_HASHCACHE_H_
+
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#include <cstdint>
+#include <fstream>
+#include <sstream>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+/**
+ * Identifies the state of a file by its metadata only, i.e.,
+ * a file is assumed to be unchanged as long as this key is unchanged
+ */
+struct FileKey {
+    uint64_t device = 0;
+    uint64_t inode = 0;
+    uint64_t size = 0;
+    int64_t mtime_ns = 0;
+
+    inline bool operator== (const FileKey& other) const {
+        return device == other.device && inode == other.inode && size == other.size && mtime_ns == other.mtime_ns;
+    }
+
+    inline bool operator!= (const FileKey& other) const {
+        return !(*this == other);
+    }
+
+    static bool of(const char* filename, FileKey* key) {
+        struct stat st;
+        if (stat(filename, &st) != 0) {
+            return false;
+        }
+        key->device = static_cast<uint64_t>(st.st_dev);
+        key->inode = static_cast<uint64_t>(st.st_ino);
+        key->size = static_cast<uint64_t>(st.st_size);
+    #if defined(__APPLE__)
+        key->mtime_ns = static_cast<int64_t>(st.st_mtimespec.tv_sec) * 1000000000 + st.st_mtimespec.tv_nsec;
+    #elif defined(_WIN32)
+        key->mtime_ns = static_cast<int64_t>(st.st_mtime) * 1000000000;
+    #else
+        key->mtime_ns = static_cast<int64_t>(st.st_mtim.tv_sec) * 1000000000 + st.st_mtim.tv_nsec;
+    #endif
+        return true;
+    }
+};
+
+namespace std {
+template<>
+struct hash<FileKey> {
+    inline size_t operator()(const FileKey& key) const {
+        uint64_t h = key.inode * 0x9E3779B97F4A7C15ull;
+        h ^= (key.device + (h << 6) + (h >> 2));
+        h ^= (key.size + (h << 6) + (h >> 2));
+        h ^= (static_cast<uint64_t>(key.mtime_ns) + (h << 6) + (h >> 2));
+        return static_cast<size_t>(h);
+    }
+};
+}
+
+/**
+ * Persistent cache of file hashes: an append-only log with one line "device inode size mtime_ns hash" per entry,
+ * which is read into an in-memory index on construction (later entries override earlier ones).
+ * Lines which are not newline-terminated, have more or fewer fields or a malformed hash (e.g., after an interrupted
+ * write) are ignored, such that the respective files are hashed again.
+ */
+class HashCache {
+    std::unordered_map<FileKey, std::string> index;
+    std::ofstream log;
+    std::mutex mutex;
+
+    // md5 hash: 32 lowercase hexadecimal digits
+    static bool valid_hash(const std::string& hash) {
+        if (hash.size() != 32) return false;
+        for (char c : hash) {
+            if (!((c >= '0' && c <= '9') || (c >= 'a' && c <= 'f'))) return false;
+        }
+        return true;
+    }
+
+    static bool parse(const std::string& line, FileKey* key, std::string* hash) {
+        std::istringstream fields(line);
+        std::string rest;
+        return (fields >> key->device >> key->inode >> key->size >> key->mtime_ns >> *hash)
+            && !(fields >> rest) && valid_hash(*hash);
+    }
+
+ public:
+    explicit HashCache(const std::string& path) : index(), log(), mutex() {
+        std::ifstream in(path);
+        std::string line;
+        bool terminated = true;
+        while (std::getline(in, line)) {
+            if (in.eof()) {  // last line without newline
+                terminated = false;
+                break;
+            }
+            FileKey key;
+            std::string hash;
+            if (parse(line, &key, &hash)) {
+                index[key] = hash;
+            }
+        }
+        in.close();
+        log.open(path, std::ios::app);
+        if (!terminated) {
+            log << std::endl;  // append new entries on a fresh line
+        }
+    }
+
+    bool lookup(const FileKey& key, std::string* hash) {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = index.find(key);
+        if (it == index.end()) return false;
+        *hash = it->second;
+        return true;
+    }
+
+    void insert(const FileKey& key, const std::string& hash) {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = index.find(key);
+        if (it != index.end() && it->second == hash) return;
+        index[key] = hash;
+        log << key.device << ' ' << key.inode << ' ' << key.size << ' ' << key.mtime_ns << ' ' << hash << std::endl;
+    }
+
+    size_t size() {
+        std::lock_guard<std::mutex> lock(mutex);
+        return index.size();
+    }
+};
+
+/**
+ * Look up the hash of the given file in the cache (if any) and compute it with hash_function otherwise;
+ * new hashes are only recorded if the file metadata did not change while hashing
+ */
+template <typename HashFunction>
+std::string cached_hash(const char* filename, HashCache* cache, HashFunction hash_function) {
+    FileKey key;
+    if (cache == nullptr || !FileKey::of(filename, &key)) {
+        return hash_function(filename);
+    }
+    std::string hash;
+    if (cache->lookup(key, &hash)) {
+        return hash;
+    }
+    hash = hash_function(filename);
+    FileKey after;
+    if (FileKey::of(filename, &after) && after == key) {
+        cache->insert(key, hash);
+    }
+    return hash;
+}
+
+#endif  // SRC_UTIL_HASHCACHE_H_
@@ -0,0 +1,161 @@
+/*************************************************************************************************
+CNFTools -- Copyright (c) 2021, Markus Iser, KIT - Karlsruhe Institute of Technology
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT
+OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ **************************************************************************************************/
+
+#ifndef SRC_UTIL_INVARIANTHASH_H_
+#define SRC_UTIL_INVARIANTHASH_H_
+
+#include <cstdint>
+#include <cstdlib>
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "src/util/StreamBuffer.h"
+#include "src/util/CNFFormula.h"
+#include "src/util/SolverTypes.h"
+
+// 64-bit finalizer (splitmix64), used to hash colors and literals
+inline uint64_t mix64(uint64_t x) {
+    x ^= x >> 30;
+    x *= 0xBF58476D1CE4E5B9ull;
+    x ^= x >> 27;
+    x *= 0x94D049BB133111EBull;
+    return x ^ (x >> 31);
+}
+
+inline uint64_t mix64(uint64_t a, uint64_t b) {
+    return mix64(a ^ mix64(b + 0x9E3779B97F4A7C15ull));
+}
+
+/**
+ * Commutative multiset hash: the digest of a multiset of 128-bit element hashes is their sum (modulo 2^64 per half),
+ * which does not depend on the order in which elements are added
+ */
+class MultisetHash {
+    uint64_t sum1 = 0;
+    uint64_t sum2 = 0;
+    uint64_t count = 0;
+
+ public:
+    inline void add(uint64_t h1, uint64_t h2) {
+        sum1 += h1;
+        sum2 += h2;
+        ++count;
+    }
+
+    std::string to_string() const {
+        static const char* hex = "0123456789abcdef";
+        uint64_t hi = mix64(sum1, count);
+        uint64_t lo = mix64(sum2, ~count);
+        std::string str(32, '0');
+        for (unsigned i = 0; i < 16; i++) {
+            str[15 - i] = hex[(hi >> (4*i)) & 0xF];
+            str[31 - i] = hex[(lo >> (4*i)) & 0xF];
+        }
+        return str;
+    }
+};
+
+/**
+ * Hash which is invariant under permutation of clauses and of literals within clauses (duplicate literals are ignored),
+ * computed in a single streaming pass: clauses are hashed individually after sorting their literals
+ * and combined into a MultisetHash
+ */
+std::string permutation_invariant_hash_from_dimacs(const char* filename) {
+    MultisetHash hash;
+    StreamBuffer in(filename);
+    std::vector<unsigned> clause;
+    while (!in.eof()) {
+        in.skipWhitespace();
+        if (in.eof()) {
+            break;
+        }
+        if (*in == 'p' || *in == 'c') {
+            in.skipLine();
+        } else {
+            for (int plit = in.readInteger(); plit != 0; plit = in.readInteger()) {
+                clause.push_back(Lit(abs(plit), plit < 0));
+            }
+            std::sort(clause.begin(), clause.end());
+            clause.erase(std::unique(clause.begin(), clause.end()), clause.end());
+            uint64_t h1 = clause.size(), h2 = ~h1;
+            for (unsigned lit : clause) {
+                h1 = mix64(h1, lit);
+                h2 = mix64(h2 ^ 0x5851F42D4C957F2Dull, lit);
+            }
+            hash.add(h1, h2);
+            clause.clear();
+        }
+    }
+    return hash.to_string();
+}
+
+/**
+ * Hash which is additionally invariant under renaming of variables (preserving polarity):
+ * literals are colored by their occurrence signature, and colors are refined for the given number of rounds
+ * by the multiset of colors of the clauses they occur in (iterated degree-signature refinement)
+ * Equal hashes do not prove that formulas are renamings of each other, different hashes prove they are not
+ */
+std::string renaming_invariant_hash(const CNFFormula& formula, unsigned rounds = 3) {
+    const size_t n_lits = 2 * formula.nVars() + 2;
+    std::vector<uint64_t> color(n_lits, 0);
+    std::vector<uint64_t> signature(n_lits, 0);
+
+    // initial coloring: (polarity, occurrences, occurrences of complement)
+    std::vector<uint64_t> occurrences(n_lits, 0);
+    for (const Cl* clause : formula) {
+        for (Lit lit : *clause) ++occurrences[lit];
+    }
+    for (Lit lit = Lit(1, false); lit < Lit(formula.nVars() + 1, false); ++lit) {
+        color[lit] = mix64(mix64(lit.sign(), occurrences[lit]), occurrences[~lit]);
+    }
+
+    auto clause_color = [&color] (const Cl* clause) {
+        uint64_t sum = 0;
+        for (Lit lit : *clause) sum += mix64(color[lit]);
+        return mix64(sum, clause->size());
+    };
+
+    for (unsigned round = 0; round < rounds; round++) {
+        std::fill(signature.begin(), signature.end(), 0);
+        for (const Cl* clause : formula) {
+            uint64_t c = mix64(clause_color(clause));
+            for (Lit lit : *clause) signature[lit] += c;
+        }
+        for (Lit lit = Lit(1, false); lit < Lit(formula.nVars() + 1, false); ++lit) {
+            // literal and complement are refined together in order to keep track of variables
+            color[lit] = mix64(mix64(color[lit], signature[lit]), signature[~lit]);
+        }
+    }
+
+    MultisetHash hash;
+    for (const Cl* clause : formula) {
+        uint64_t c = clause_color(clause);
+        hash.add(mix64(c, 1), mix64(c, 2));
+    }
+    return hash.to_string();
+}
+
+std::string renaming_invariant_hash_from_dimacs(const char* filename, unsigned rounds = 3) {
+    CNFFormula formula;
+    formula.readDimacsFromFile(filename);
+    return renaming_invariant_hash(formula, rounds);
+}
+
+#endif  // SRC_UTIL_INVARIANTHASH_H_
@@ -0,0 +1,140 @@
+/*************************************************************************************************
+CNFTools -- Copyright (c) 2021, Markus Iser, KIT - Karlsruhe Institute of Technology
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT
+OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ **************************************************************************************************/
+
+#ifndef SRC_UTIL_MD5LANES_H_
+#define SRC_UTIL_MD5LANES_H_
+
+#include <cstdint>
+#include <cstring>
+
+// message words are loaded and digests stored in host byte order, which is the md5 byte order only on little-endian hosts
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ != __ORDER_LITTLE_ENDIAN__
+#error "MD5Lanes requires a little-endian host"
+#endif
+
+/**
+ * Multi-buffer MD5 core: computes the MD5 block function for eight independent streams at once,
+ * one stream per 32-bit lane of a 256-bit vector (compiles to AVX2 if enabled, e.g. with -mavx2,
+ * and to narrower SIMD or scalar code otherwise).
+ * Padding and length encoding are left to the caller, i.e., each lane has to be fed complete 64-byte blocks.
+ */
+class MD5Lanes {
+ public:
+    static constexpr unsigned lanes = 8;
+    typedef uint32_t vec __attribute__((vector_size(4 * lanes)));
+
+ private:
+    vec A, B, C, D;
+
+ public:
+    MD5Lanes() {
+        for (unsigned lane = 0; lane < lanes; lane++) reset(lane);
+    }
+
+    void reset(unsigned lane) {
+        A[lane] = 0x67452301;
+        B[lane] = 0xefcdab89;
+        C[lane] = 0x98badcfe;
+        D[lane] = 0x10325476;
+    }
+
+    // digest of lane in md5 byte order (16 bytes)
+    void digest(unsigned lane, unsigned char* signature) const {
+        uint32_t words[4] = { A[lane], B[lane], C[lane], D[lane] };
+        memcpy(signature, words, sizeof(words));
+    }
+
+    /**
+     * Process one 64-byte block per lane; lanes with a null block pointer keep their state
+     */
+    void process(const unsigned char* const block[lanes]) {
+        // transpose: word k of all lanes into X[k]
+        uint32_t words[16][lanes] = {};
+        uint32_t mask[lanes] = {};
+        for (unsigned lane = 0; lane < lanes; lane++) {
+            if (block[lane] == nullptr) continue;
+            mask[lane] = 0xFFFFFFFF;
+            for (unsigned k = 0; k < 16; k++) {
+                memcpy(&words[k][lane], block[lane] + 4*k, 4);
+            }
+        }
+        vec X[16], active;
+        memcpy(X, words, sizeof(X));
+        memcpy(&active, mask, sizeof(active));
+
+        vec a = A, b = B, c = C, d = D;
+
+        #define MD5_STEP(f, w, x, y, z, k, t, s) \
+            w += f(x, y, z) + X[k] + (uint32_t)t; \
+            w = ((w << s) | (w >> (32 - s))) + x;
+        #define MD5_F(x, y, z) ((x & y) | (~x & z))
+        #define MD5_G(x, y, z) ((x & z) | (y & ~z))
+        #define MD5_H(x, y, z) (x ^ y ^ z)
+        #define MD5_I(x, y, z) (y ^ (x | ~z))
+
+        MD5_STEP(MD5_F, a, b, c, d,  0, 0xd76aa478,  7) MD5_STEP(MD5_F, d, a, b, c,  1, 0xe8c7b756, 12)
+        MD5_STEP(MD5_F, c, d, a, b,  2, 0x242070db, 17) MD5_STEP(MD5_F, b, c, d, a,  3, 0xc1bdceee, 22)
+        MD5_STEP(MD5_F, a, b, c, d,  4, 0xf57c0faf,  7) MD5_STEP(MD5_F, d, a, b, c,  5, 0x4787c62a, 12)
+        MD5_STEP(MD5_F, c, d, a, b,  6, 0xa8304613, 17) MD5_STEP(MD5_F, b, c, d, a,  7, 0xfd469501, 22)
+        MD5_STEP(MD5_F, a, b, c, d,  8, 0x698098d8,  7) MD5_STEP(MD5_F, d, a, b, c,  9, 0x8b44f7af, 12)
+        MD5_STEP(MD5_F, c, d, a, b, 10, 0xffff5bb1, 17) MD5_STEP(MD5_F, b, c, d, a, 11, 0x895cd7be, 22)
+        MD5_STEP(MD5_F, a, b, c, d, 12, 0x6b901122,  7) MD5_STEP(MD5_F, d, a, b, c, 13, 0xfd987193, 12)
+        MD5_STEP(MD5_F, c, d, a, b, 14, 0xa679438e, 17) MD5_STEP(MD5_F, b, c, d, a, 15, 0x49b40821, 22)
+
+        MD5_STEP(MD5_G, a, b, c, d,  1, 0xf61e2562,  5) MD5_STEP(MD5_G, d, a, b, c,  6, 0xc040b340,  9)
+        MD5_STEP(MD5_G, c, d, a, b, 11, 0x265e5a51, 14) MD5_STEP(MD5_G, b, c, d, a,  0, 0xe9b6c7aa, 20)
+        MD5_STEP(MD5_G, a, b, c, d,  5, 0xd62f105d,  5) MD5_STEP(MD5_G, d, a, b, c, 10, 0x02441453,  9)
+        MD5_STEP(MD5_G, c, d, a, b, 15, 0xd8a1e681, 14) MD5_STEP(MD5_G, b, c, d, a,  4, 0xe7d3fbc8, 20)
+        MD5_STEP(MD5_G, a, b, c, d,  9, 0x21e1cde6,  5) MD5_STEP(MD5_G, d, a, b, c, 14, 0xc33707d6,  9)
+        MD5_STEP(MD5_G, c, d, a, b,  3, 0xf4d50d87, 14) MD5_STEP(MD5_G, b, c, d, a,  8, 0x455a14ed, 20)
+        MD5_STEP(MD5_G, a, b, c, d, 13, 0xa9e3e905,  5) MD5_STEP(MD5_G, d, a, b, c,  2, 0xfcefa3f8,  9)
+        MD5_STEP(MD5_G, c, d, a, b,  7, 0x676f02d9, 14) MD5_STEP(MD5_G, b, c, d, a, 12, 0x8d2a4c8a, 20)
+
+        MD5_STEP(MD5_H, a, b, c, d,  5, 0xfffa3942,  4) MD5_STEP(MD5_H, d, a, b, c,  8, 0x8771f681, 11)
+        MD5_STEP(MD5_H, c, d, a, b, 11, 0x6d9d6122, 16) MD5_STEP(MD5_H, b, c, d, a, 14, 0xfde5380c, 23)
+        MD5_STEP(MD5_H, a, b, c, d,  1, 0xa4beea44,  4) MD5_STEP(MD5_H, d, a, b, c,  4, 0x4bdecfa9, 11)
+        MD5_STEP(MD5_H, c, d, a, b,  7, 0xf6bb4b60, 16) MD5_STEP(MD5_H, b, c, d, a, 10, 0xbebfbc70, 23)
+        MD5_STEP(MD5_H, a, b, c, d, 13, 0x289b7ec6,  4) MD5_STEP(MD5_H, d, a, b, c,  0, 0xeaa127fa, 11)
+        MD5_STEP(MD5_H, c, d, a, b,  3, 0xd4ef3085, 16) MD5_STEP(MD5_H, b, c, d, a,  6, 0x04881d05, 23)
+        MD5_STEP(MD5_H, a, b, c, d,  9, 0xd9d4d039,  4) MD5_STEP(MD5_H, d, a, b, c, 12, 0xe6db99e5, 11)
+        MD5_STEP(MD5_H, c, d, a, b, 15, 0x1fa27cf8, 16) MD5_STEP(MD5_H, b, c, d, a,  2, 0xc4ac5665, 23)
+
+        MD5_STEP(MD5_I, a, b, c, d,  0, 0xf4292244,  6) MD5_STEP(MD5_I, d, a, b, c,  7, 0x432aff97, 10)
+        MD5_STEP(MD5_I, c, d, a, b, 14, 0xab9423a7, 15) MD5_STEP(MD5_I, b, c, d, a,  5, 0xfc93a039, 21)
+        MD5_STEP(MD5_I, a, b, c, d, 12, 0x655b59c3,  6) MD5_STEP(MD5_I, d, a, b, c,  3, 0x8f0ccc92, 10)
+        MD5_STEP(MD5_I, c, d, a, b, 10, 0xffeff47d, 15) MD5_STEP(MD5_I, b, c, d, a,  1, 0x85845dd1, 21)
+        MD5_STEP(MD5_I, a, b, c, d,  8, 0x6fa87e4f,  6) MD5_STEP(MD5_I, d, a, b, c, 15, 0xfe2ce6e0, 10)
+        MD5_STEP(MD5_I, c, d, a, b,  6, 0xa3014314, 15) MD5_STEP(MD5_I, b, c, d, a, 13, 0x4e0811a1, 21)
+        MD5_STEP(MD5_I, a, b, c, d,  4, 0xf7537e82,  6) MD5_STEP(MD5_I, d, a, b, c, 11, 0xbd3af235, 10)
+        MD5_STEP(MD5_I, c, d, a, b,  2, 0x2ad7d2bb, 15) MD5_STEP(MD5_I, b, c, d, a,  9, 0xeb86d391, 21)
+
+        #undef MD5_STEP
+        #undef MD5_F
+        #undef MD5_G
+        #undef MD5_H
+        #undef MD5_I
+
+        A += a & active;
+        B += b & active;
+        C += c & active;
+        D += d & active;
+    }
+};
+
+#endif  // SRC_UTIL_MD5LANES_H_
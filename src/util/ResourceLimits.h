@@ -23,6 +23,7 @@ OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWA
 #include <iomanip>
 #include <iostream>
 #include <cstdint>
+#include <chrono>
 #include <exception>
 
 #ifdef _WIN32
@@ -49,22 +50,25 @@ struct ResourceLimitsExceeded : public std::exception {
 };
 
 
+/**
+ * Time limit (seconds) and memory limit (megabytes), where 0 means unlimited.
+ * Runtime is wallclock time since construction (monotonic), since cpu time would sum up over worker threads.
+ */
 class ResourceLimits {
     unsigned rlim_;
     unsigned mlim_;
 
-    unsigned time_;
+    std::chrono::steady_clock::time_point start_;
 
  public:
     ResourceLimits(unsigned rlim, unsigned mlim)
-     : rlim_(rlim), mlim_(mlim) {
-        time_ = get_cpu_time();
-    }
+     : rlim_(rlim), mlim_(mlim), start_(std::chrono::steady_clock::now()) { }
 
     ResourceLimits() : ResourceLimits(0, 0) { }
 
-    unsigned get_runtime() const {
-        return get_cpu_time() - time_;
+    // wallclock time in seconds since construction
+    double get_runtime() const {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start_).count();
     }
 
     unsigned get_memory() const {
@@ -0,0 +1,272 @@
+/*************************************************************************************************
+CNFTools -- Copyright (c) 2021, Markus Iser, KIT - Karlsruhe Institute of Technology
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT
+OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ **************************************************************************************************/
+
+#ifndef SRC_UTIL_SKETCHES_H_
+#define SRC_UTIL_SKETCHES_H_
+
+#include <math.h>
+
+#include <cstdint>
+#include <vector>
+#include <algorithm>
+#include <limits>
+#include <utility>
+
+#include "src/util/InvariantHash.h"
+
+/**
+ * HyperLogLog cardinality estimator over 64-bit hashes with 2^precision one-byte registers
+ * (relative standard error 1.04 / sqrt(2^precision), linear counting for small cardinalities)
+ */
+class HyperLogLog {
+    unsigned precision_;
+    std::vector<uint8_t> registers_;
+
+ public:
+    explicit HyperLogLog(unsigned precision = 14) : precision_(precision), registers_(size_t(1) << precision, 0) { }
+
+    inline void add(uint64_t hash) {
+        size_t index = hash >> (64 - precision_);
+        uint64_t rest = hash << precision_;
+        uint8_t rank = rest == 0 ? 64 - precision_ + 1 : __builtin_clzll(rest) + 1;
+        if (rank > registers_[index]) registers_[index] = rank;
+    }
+
+    double estimate() const {
+        const double m = registers_.size();
+        double sum = 0;
+        unsigned zeros = 0;
+        for (uint8_t r : registers_) {
+            sum += ldexp(1.0, -r);
+            if (r == 0) ++zeros;
+        }
+        double raw = 0.7213 / (1 + 1.079 / m) * m * m / sum;
+        if (raw <= 2.5 * m && zeros > 0) {
+            return m * log(m / zeros);
+        }
+        return raw;
+    }
+
+    double relative_error() const {
+        return 1.04 / sqrt(registers_.size());
+    }
+};
+
+/**
+ * Count-min sketch with conservative update: depth rows of width counters (width is a power of two),
+ * estimates never underestimate, and overestimate by at most e / width * total with probability 1 - exp(-depth)
+ */
+class CountMinSketch {
+    static constexpr unsigned max_depth = 8;
+    unsigned width_, depth_;
+    std::vector<uint32_t> table_;
+
+    // counter of key in each row (double hashing of one 64-bit hash)
+    inline void cells(uint64_t key, size_t* cell) const {
+        uint64_t hash = mix64(key);
+        uint64_t h1 = hash & 0xFFFFFFFF, h2 = (hash >> 32) | 1;
+        for (unsigned row = 0; row < depth_; row++) {
+            cell[row] = row * size_t(width_) + ((h1 + row * h2) & (width_ - 1));
+        }
+    }
+
+ public:
+    explicit CountMinSketch(unsigned width = 1 << 16, unsigned depth = 4) :
+        width_(width), depth_(std::min(depth, max_depth)), table_(size_t(width) * depth_, 0) { }
+
+    // Adds one occurrence of key (incrementing only the minimal counters) and returns the new estimate of its count
+    inline uint32_t add(uint64_t key) {
+        size_t cell[max_depth];
+        cells(key, cell);
+        uint32_t estimate = UINT32_MAX;
+        for (unsigned row = 0; row < depth_; row++) {
+            estimate = std::min(estimate, table_[cell[row]]);
+        }
+        ++estimate;
+        for (unsigned row = 0; row < depth_; row++) {
+            table_[cell[row]] = std::max(table_[cell[row]], estimate);
+        }
+        return estimate;
+    }
+
+    inline uint32_t estimate(uint64_t key) const {
+        size_t cell[max_depth];
+        cells(key, cell);
+        uint32_t estimate = UINT32_MAX;
+        for (unsigned row = 0; row < depth_; row++) {
+            estimate = std::min(estimate, table_[cell[row]]);
+        }
+        return estimate;
+    }
+
+    // Expected overestimate of a single count, given the total of all counts
+    double error(uint64_t total) const {
+        return static_cast<double>(total) / width_;
+    }
+};
+
+/**
+ * Quantile sketch with relative accuracy: the first exact_limit samples are kept as they are (exact quantiles),
+ * beyond that all samples are counted in logarithmic buckets (as in DDSketch), where bucket i of positive values
+ * covers [gamma^(i-1/2), gamma^(i+1/2)) with gamma = (1 + accuracy)^2 and is represented by gamma^i, such that
+ * each quantile is off by at most accuracy times its value (and 1 is represented exactly).
+ * Values with magnitude below min_value are counted as zero, NaN is ranked last.
+ * Bucket counts are additive, so the result does not depend on the order of samples and merges
+ * (e.g., on the number of threads).
+ */
+template <typename T>
+class QuantileSketch {
+    // Bucket counters for indices offset, offset + 1, ... (grown on demand)
+    struct Buckets {
+        int offset = 0;
+        std::vector<uint64_t> counts;
+
+        inline void add(int index, uint64_t count) {
+            if (counts.empty()) {
+                offset = index;
+            } else if (index < offset) {
+                counts.insert(counts.begin(), offset - index, 0);
+                offset = index;
+            }
+            if (static_cast<size_t>(index - offset) >= counts.size()) {
+                counts.resize(index - offset + 1, 0);
+            }
+            counts[index - offset] += count;
+        }
+    };
+
+    uint64_t n_ = 0;
+    std::vector<T> samples_;  // all samples as long as n_ <= exact_limit
+    Buckets positive_, negative_;  // logarithmic buckets of positive and negative values (by magnitude)
+    uint64_t zeros_ = 0, nans_ = 0;
+
+    static inline bool nan(T value) {
+        return value != value;
+    }
+
+    // strict weak order with NaN after all other values
+    static inline bool less(T a, T b) {
+        return a < b || (!nan(a) && nan(b));
+    }
+
+    static inline double log_gamma() {
+        static const double result = 2 * log1p(accuracy);
+        return result;
+    }
+
+    static inline double bucket_value(int index) {
+        return exp(index * log_gamma());
+    }
+
+    inline void count(T value, uint64_t times) {
+        const double x = static_cast<double>(value);
+        if (nan(value)) {
+            nans_ += times;
+        } else if (fabs(x) < min_value) {
+            zeros_ += times;
+        } else {
+            const double magnitude = std::min(fabs(x), 1e300);
+            const int index = static_cast<int>(lround(log(magnitude) / log_gamma()));
+            (x > 0 ? positive_ : negative_).add(index, times);
+        }
+    }
+
+    // moves the exact samples to the buckets
+    void spill() {
+        for (T value : samples_) count(value, 1);
+        samples_.clear();
+        samples_.shrink_to_fit();
+    }
+
+ public:
+    static constexpr size_t exact_limit = 1 << 16;
+    static constexpr double accuracy = 0.005;
+    static constexpr double min_value = 1e-9;
+
+    inline void add(T value) {
+        ++n_;
+        if (n_ <= exact_limit) {
+            samples_.push_back(value);
+            return;
+        }
+        if (!samples_.empty()) spill();
+        count(value, 1);
+    }
+
+    void merge(const QuantileSketch<T>& other) {
+        if (other.n_ == 0) return;
+        const bool exact = n_ + other.n_ <= exact_limit;
+        n_ += other.n_;
+        if (exact) {
+            samples_.insert(samples_.end(), other.samples_.begin(), other.samples_.end());
+            return;
+        }
+        spill();
+        for (T value : other.samples_) count(value, 1);
+        for (size_t i = 0; i < other.positive_.counts.size(); i++) {
+            if (other.positive_.counts[i] > 0) positive_.add(other.positive_.offset + i, other.positive_.counts[i]);
+        }
+        for (size_t i = 0; i < other.negative_.counts.size(); i++) {
+            if (other.negative_.counts[i] > 0) negative_.add(other.negative_.offset + i, other.negative_.counts[i]);
+        }
+        zeros_ += other.zeros_;
+        nans_ += other.nans_;
+    }
+
+    inline uint64_t size() const {
+        return n_;
+    }
+
+    // Quantiles are exact as long as there are at most exact_limit samples
+    inline bool exact() const {
+        return n_ <= exact_limit;
+    }
+
+    // Sample at index floor(q * (n - 1)) of the sorted stream (relative error at most accuracy if not exact)
+    T quantile(double q) const {
+        if (n_ == 0) return T();
+        const uint64_t index = static_cast<uint64_t>(std::min(1.0, std::max(0.0, q)) * (n_ - 1) + 1e-9);
+        if (exact()) {
+            std::vector<T> sorted(samples_);
+            std::nth_element(sorted.begin(), sorted.begin() + index, sorted.end(), less);
+            return sorted[index];
+        }
+        uint64_t count = 0;
+        for (size_t i = negative_.counts.size(); i-- > 0; ) {
+            count += negative_.counts[i];
+            if (count > index) return static_cast<T>(-bucket_value(negative_.offset + i));
+        }
+        count += zeros_;
+        if (count > index) return T();
+        for (size_t i = 0; i < positive_.counts.size(); i++) {
+            count += positive_.counts[i];
+            if (count > index) return static_cast<T>(bucket_value(positive_.offset + i));
+        }
+        return std::numeric_limits<T>::quiet_NaN();
+    }
+
+    // Bound of the absolute error of quantile(q)
+    double quantile_error(double q) const {
+        if (exact()) return 0;
+        const double value = fabs(static_cast<double>(quantile(q)));
+        return value == 0 ? min_value : accuracy * value;
+    }
+};
+
+#endif  // SRC_UTIL_SKETCHES_H_
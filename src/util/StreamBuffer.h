@@ -61,6 +61,7 @@ class StreamBuffer {
             end += archive_read_data(file, buffer + end, buffer_size - end);
             if (end < buffer_size) {
                 end_of_file = true;
+                buffer[end] = '\0';  // strtol must not read past the last number if the file does not end with whitespace
             } else {
                 while (!isspace(buffer[end-1])) {  // align buffer with word-end
                     end--;
@@ -0,0 +1,249 @@
+/*************************************************************************************************
+CNFTools -- Copyright (c) 2021, Markus Iser, KIT - Karlsruhe Institute of Technology
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT
+OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ **************************************************************************************************/
+
+#ifndef SRC_UTIL_THREADPOOL_H_
+#define SRC_UTIL_THREADPOOL_H_
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <deque>
+#include <vector>
+#include <algorithm>
+#include <atomic>
+#include <exception>
+
+#include "src/util/ResourceLimits.h"
+
+/**
+ * Fixed set of worker threads consuming tasks from a bounded queue;
+ * submit() blocks while the queue is full, such that producers which
+ * stream their input (e.g. a path list from stdin) run in bounded memory.
+ * The first exception thrown by a task is rethrown by join(), remaining tasks are skipped.
+ */
+class ThreadPool {
+    std::vector<std::thread> workers;
+    std::deque<std::function<void()>> tasks;
+
+    std::mutex mutex;
+    std::condition_variable has_task;
+    std::condition_variable has_space;
+
+    size_t capacity;
+    bool closed;
+    std::exception_ptr error;  // first exception of a task
+
+    void work() {
+        while (true) {
+            std::function<void()> task;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                has_task.wait(lock, [this] { return closed || !tasks.empty(); });
+                if (tasks.empty()) return;
+                task = std::move(tasks.front());
+                tasks.pop_front();
+                if (error) task = nullptr;
+            }
+            has_space.notify_one();
+            if (!task) continue;
+            try {
+                task();
+            } catch (...) {
+                std::unique_lock<std::mutex> lock(mutex);
+                if (!error) error = std::current_exception();
+            }
+        }
+    }
+
+    void stop() {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            closed = true;
+        }
+        has_task.notify_all();
+        for (std::thread& worker : workers) {
+            if (worker.joinable()) worker.join();
+        }
+    }
+
+ public:
+    explicit ThreadPool(unsigned threads, size_t capacity_ = 0) : workers(), tasks(), closed(false) {
+        threads = resolve(threads);
+        capacity = capacity_ > 0 ? capacity_ : 4 * threads;
+        for (unsigned i = 0; i < threads; i++) {
+            workers.emplace_back(&ThreadPool::work, this);
+        }
+    }
+
+    ~ThreadPool() {
+        stop();
+    }
+
+    // number of threads to use if 0 (= all cores) is requested
+    static unsigned resolve(unsigned threads) {
+        return threads > 0 ? threads : std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    unsigned size() const {
+        return workers.size();
+    }
+
+    void submit(std::function<void()> task) {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            has_space.wait(lock, [this] { return tasks.size() < capacity; });
+            tasks.push_back(std::move(task));
+        }
+        has_task.notify_one();
+    }
+
+    // process remaining tasks, stop workers and rethrow the first exception of a task
+    void join() {
+        stop();
+        if (error) std::rethrow_exception(error);
+    }
+};
+
+/**
+ * Process-wide workers for the fork-join calls of parallel_for, which are created on demand and reused,
+ * such that short parallel loops (e.g. per Lanczos iteration) do not start new threads on every call.
+ * A thread which waits for its blocks runs queued blocks itself, such that nested calls cannot deadlock.
+ */
+class ForkJoinPool {
+    std::vector<std::thread> workers;
+    std::deque<std::function<void()>> tasks;
+    std::mutex mutex;
+    std::condition_variable changed;  // new task or completed block
+    bool closed = false;
+
+    ForkJoinPool() = default;
+
+    ~ForkJoinPool() {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            closed = true;
+        }
+        changed.notify_all();
+        for (std::thread& worker : workers) worker.join();
+    }
+
+    void work() {
+        std::unique_lock<std::mutex> lock(mutex);
+        while (true) {
+            changed.wait(lock, [this] { return closed || !tasks.empty(); });
+            if (closed) return;
+            run_front(&lock);
+        }
+    }
+
+    // runs the first task without holding the lock
+    void run_front(std::unique_lock<std::mutex>* lock) {
+        std::function<void()> task = std::move(tasks.front());
+        tasks.pop_front();
+        lock->unlock();
+        task();
+        lock->lock();
+    }
+
+ public:
+    static ForkJoinPool& instance() {
+        static ForkJoinPool pool;
+        return pool;
+    }
+
+    /**
+     * Calls f(t) for t in [0, n), where f(0) runs in the calling thread;
+     * rethrows the first exception after all calls have returned
+     */
+    template <typename Function>
+    void run(unsigned n, Function f) {
+        std::exception_ptr error;
+        unsigned pending = n - 1;
+        auto call = [&] (unsigned t) {
+            try {
+                f(t);
+            } catch (...) {
+                std::unique_lock<std::mutex> lock(mutex);
+                if (!error) error = std::current_exception();
+            }
+        };
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            while (workers.size() < n - 1) workers.emplace_back(&ForkJoinPool::work, this);
+            for (unsigned t = 1; t < n; t++) {
+                tasks.emplace_back([&, t] () {
+                    call(t);
+                    std::unique_lock<std::mutex> lock(mutex);
+                    --pending;
+                    changed.notify_all();
+                });
+            }
+        }
+        changed.notify_all();
+        call(0);
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            while (pending > 0) {
+                if (!tasks.empty()) {
+                    run_front(&lock);
+                } else {
+                    changed.wait(lock);
+                }
+            }
+        }
+        if (error) std::rethrow_exception(error);
+    }
+};
+
+/**
+ * Split the index range [0, n) into one contiguous block per thread and call f(thread, begin, end) for each block
+ * on the workers of ForkJoinPool (runs in the calling thread if only one thread is requested).
+ * The first exception thrown by a block (e.g. std::bad_alloc) is rethrown after all blocks have returned.
+ */
+template <typename Function>
+void parallel_for(size_t n, unsigned threads, Function f) {
+    threads = std::min<size_t>(ThreadPool::resolve(threads), std::max<size_t>(n, 1));
+    if (threads == 1) {
+        f(0u, size_t(0), n);
+        return;
+    }
+    ForkJoinPool::instance().run(threads, [&f, n, threads] (unsigned t) {
+        f(t, n * t / threads, n * (t + 1) / threads);
+    });
+}
+
+/**
+ * Calls f(thread, begin, end) for chunks of [0, n), distributed over contiguous ranges per thread.
+ * Each thread checks the resource limits between its chunks and stops early if they are exceeded,
+ * in which case ResourceLimitsExceeded is thrown after all threads have stopped.
+ */
+template <typename Function>
+void for_each_chunk(size_t n, unsigned threads, const ResourceLimits& limits, Function f, size_t chunk = 1 << 16) {
+    std::atomic<bool> exceeded(false);
+    parallel_for(n, threads, [&limits, &f, &exceeded, chunk] (unsigned t, size_t begin, size_t end) {
+        for (size_t pos = begin; pos < end && !exceeded; pos += chunk) {
+            f(t, pos, std::min(pos + chunk, end));
+            if (!limits.within_limits()) exceeded = true;
+        }
+    });
+    if (exceeded) throw ResourceLimitsExceeded();
+}
+
+#endif  // SRC_UTIL_THREADPOOL_H_
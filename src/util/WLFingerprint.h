@@ -0,0 +1,147 @@
+/*************************************************************************************************
+CNFTools -- Copyright (c) 2021, Markus Iser, KIT - Karlsruhe Institute of Technology
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT
+OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ **************************************************************************************************/
+
+#ifndef SRC_UTIL_WLFINGERPRINT_H_
+#define SRC_UTIL_WLFINGERPRINT_H_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <unordered_set>
+
+#include "src/util/CNFFormula.h"
+#include "src/util/SolverTypes.h"
+#include "src/util/ResourceLimits.h"
+#include "src/util/ThreadPool.h"
+#include "src/util/InvariantHash.h"
+
+/**
+ * Weisfeiler-Lehman (color refinement) fingerprint of the literal-clause incidence graph
+ * (literal nodes are also connected to their complement), invariant under renaming of variables,
+ * flipping of polarities, and permutation of clauses or literals.
+ * Neighbour multisets are hashed sort-free by summation of mixed colors, and each round is computed in parallel
+ * (clauses pull from literals, literals pull from their occurrence list).
+ * Refinement stops when the number of color classes does not increase anymore.
+ */
+class WLFingerprint {
+    const CNFFormula& formula_;
+    const ResourceLimits& limits_;
+    unsigned threads_;
+
+    std::vector<uint64_t> lit_color, clause_color;
+    std::vector<uint64_t> next_lit_color, next_clause_color;
+
+    // occurrence lists in CSR layout: clauses of literal l are occ[occ_begin[l]..occ_begin[l+1])
+    std::vector<unsigned> occ_begin, occ;
+
+    // literals of variables which occur in the formula (unused variable names are ignored)
+    std::vector<unsigned> active;
+
+    unsigned rounds_;
+    std::string fingerprint_;
+
+    void build_occurrences() {
+        const size_t n_lits = lit_color.size();
+        occ_begin.assign(n_lits + 1, 0);
+        for (const Cl* clause : formula_) {
+            for (Lit lit : *clause) ++occ_begin[lit + 1];
+        }
+        for (size_t l = 0; l < n_lits; l++) {
+            occ_begin[l + 1] += occ_begin[l];
+        }
+        occ.resize(occ_begin[n_lits]);
+        std::vector<unsigned> pos(occ_begin.begin(), occ_begin.end() - 1);
+        unsigned cid = 0;
+        for (const Cl* clause : formula_) {
+            for (Lit lit : *clause) occ[pos[lit]++] = cid;
+            ++cid;
+        }
+        active.clear();
+        for (size_t l = 2; l < n_lits; l++) {
+            if (occ_begin[l + 1] > occ_begin[l] || occ_begin[(l ^ 1) + 1] > occ_begin[l ^ 1]) active.push_back(l);
+        }
+    }
+
+    void refine() {
+        parallel_for(formula_.nClauses(), threads_, [this] (unsigned, size_t begin, size_t end) {
+            for (size_t c = begin; c < end; c++) {
+                uint64_t sum = 0;
+                for (Lit lit : *formula_[c]) sum += mix64(lit_color[lit]);
+                next_clause_color[c] = mix64(clause_color[c], sum);
+            }
+        });
+        parallel_for(lit_color.size(), threads_, [this] (unsigned, size_t begin, size_t end) {
+            for (size_t l = begin; l < end; l++) {
+                uint64_t sum = 0;
+                for (unsigned i = occ_begin[l]; i < occ_begin[l + 1]; i++) sum += mix64(clause_color[occ[i]]);
+                next_lit_color[l] = mix64(mix64(lit_color[l], sum), lit_color[l ^ 1]);
+            }
+        });
+        lit_color.swap(next_lit_color);
+        clause_color.swap(next_clause_color);
+    }
+
+    size_t count_colors() const {
+        std::unordered_set<uint64_t> colors;
+        colors.reserve(active.size() + clause_color.size());
+        for (unsigned l : active) colors.insert(lit_color[l]);
+        colors.insert(clause_color.begin(), clause_color.end());
+        return colors.size();
+    }
+
+ public:
+    WLFingerprint(const CNFFormula& formula, const ResourceLimits& limits, unsigned threads = 1) :
+     formula_(formula), limits_(limits), threads_(threads), rounds_(0), fingerprint_() { }
+
+    void analyze(unsigned max_rounds = 64) {
+        const size_t n_lits = 2 * formula_.nVars() + 2;
+        lit_color.assign(n_lits, mix64(1));
+        clause_color.assign(formula_.nClauses(), mix64(2));
+        next_lit_color.resize(n_lits);
+        next_clause_color.resize(formula_.nClauses());
+        build_occurrences();
+
+        size_t classes = count_colors();
+        for (rounds_ = 0; rounds_ < max_rounds; ) {
+            limits_.within_limits_or_throw();
+            refine();
+            ++rounds_;
+            size_t refined = count_colors();
+            if (refined == classes) break;
+            classes = refined;
+        }
+
+        MultisetHash hash;
+        for (unsigned l : active) hash.add(mix64(lit_color[l], 1), mix64(lit_color[l], 2));
+        for (uint64_t c : clause_color) hash.add(mix64(c, 3), mix64(c, 4));
+        fingerprint_ = hash.to_string();
+    }
+
+    // 128-bit fingerprint (hex)
+    std::string fingerprint() const {
+        return fingerprint_;
+    }
+
+    // number of refinement rounds until the coloring was stable
+    unsigned rounds() const {
+        return rounds_;
+    }
+};
+
+#endif  // SRC_UTIL_WLFINGERPRINT_H_
@@ -0,0 +1,148 @@
+/*************************************************************************************************
+CNFTools -- Copyright (c) 2021, Markus Iser, KIT - Karlsruhe Institute of Technology
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT
+OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ **************************************************************************************************/
+
+#include <math.h>
+
+#include <chrono>
+#include <map>
+#include <random>
+#include <sstream>
+#include <string>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "src/util/CNFFormula.h"
+#include "src/util/ResourceLimits.h"
+#include "src/features/CNFStats.h"
+#include "src/features/ApproxCNFStats.h"
+
+#include "test/Check.h"
+
+// Random formula with clauses of sizes 1 to 6 over variables with skewed occurrence frequencies
+static std::string random_formula(const std::string& name, unsigned vars, unsigned clauses) {
+    std::mt19937 rng(11);
+    std::ostringstream out;
+    out << "p cnf " << vars << " " << clauses << "\n";
+    for (unsigned c = 0; c < clauses; c++) {
+        const unsigned size = 1 + rng() % 6;
+        for (unsigned k = 0; k < size; k++) {
+            const unsigned var = 1 + static_cast<unsigned>(vars * pow((rng() % 10000) / 10000.0, 2));
+            out << (rng() % 2 ? "" : "-") << var << " ";
+        }
+        out << "0\n";
+    }
+    return write_file(name, out.str());
+}
+
+static std::map<std::string, float> exact_features(const std::string& filename) {
+    CNFFormula formula;
+    formula.readDimacsFromFile(filename.c_str());
+    ResourceLimits limits(0, 0);
+    CNFStats stats(formula, limits);
+    stats.analyze();
+    std::map<std::string, float> features;
+    std::vector<float> record = stats.BaseFeatures();
+    std::vector<std::string> names = stats.FeatureNames();
+    for (unsigned i = 0; i + 1 < record.size(); i++) features[names[i]] = record[i];
+    return features;
+}
+
+int main() {
+    {  // limits exceeded before the first group: nothing is reported but the group where it stopped
+        const std::string filename = random_formula("approx_timeout.cnf", 100, 400);
+        ResourceLimits limits(1, 0);
+        std::this_thread::sleep_for(std::chrono::milliseconds(1100));
+        ApproxCNFStats stats(filename.c_str(), limits);
+        bool exceeded = false;
+        try {
+            stats.analyze();
+        } catch (ResourceLimitsExceeded& e) {
+            exceeded = true;
+        }
+        CHECK(exceeded);
+        CHECK(stats.StoppedAt() == "sizes");
+        CHECK(stats.FeatureNames().size() == 1);
+        CHECK(stats.BaseFeatures().size() == 1);
+        CHECK(stats.BaseFeatureErrors().size() == 1);
+    }
+
+    const std::string filename = random_formula("approx.cnf", 3000, 12000);
+    const std::map<std::string, float> exact = exact_features(filename);
+
+    {  // all variables in the sample: exact values, no errors
+        ResourceLimits limits(0, 0);
+        ApproxCNFStats stats(filename.c_str(), limits, 1 << 16);
+        stats.analyze();
+        CHECK(stats.StoppedAt() == "");
+        std::vector<float> record = stats.BaseFeatures(), errors = stats.BaseFeatureErrors();
+        std::vector<std::string> names = stats.FeatureNames();
+        CHECK(names.size() > 1);
+        for (unsigned i = 0; i + 1 < record.size(); i++) {
+            CHECK(exact.count(names[i]) == 1);
+            if (exact.count(names[i]) == 0) continue;
+            CHECK(errors[i] == 0);
+            CHECK_NEAR(record[i], exact.at(names[i]), 1e-3 * fabs(exact.at(names[i])) + 1e-4);
+        }
+    }
+
+    {  // sampled variables and clauses: quantile errors and the range of the maximum contain the exact value
+        ResourceLimits limits(0, 0);
+        ApproxCNFStats stats(filename.c_str(), limits, 300);
+        stats.analyze();
+        std::vector<float> record = stats.BaseFeatures(), errors = stats.BaseFeatureErrors(), biases = stats.BaseFeatureBiases();
+        std::vector<std::string> names = stats.FeatureNames();
+        unsigned bounded = 0;
+        for (unsigned i = 0; i + 1 < record.size(); i++) {
+            const std::string& name = names[i];
+            const double expected = exact.at(name);
+            const std::string suffix = name.substr(std::min(name.size(), name.rfind('_')));
+            if (suffix == "_median" || suffix == "_p90" || suffix == "_p99") {
+                CHECK_NEAR(record[i], expected, errors[i]);
+                if (errors[i] > 0) ++bounded;
+            } else if (name == "vcg_vdegrees_max") {
+                CHECK(record[i] <= expected && expected <= record[i] + errors[i]);
+            } else if (suffix == "_mean") {
+                CHECK_NEAR(record[i], expected, 4 * errors[i] + 1e-4);
+            } else if (suffix == "_entropy") {  // plug-in estimates are biased low
+                CHECK(biases[i] <= 0);
+                CHECK(record[i] <= expected + 4 * errors[i] + 1e-4);
+            }
+            CHECK(ApproxCNFStats::HasBias(name) || biases[i] == 0);
+        }
+        CHECK(bounded >= 5);  // sampled quantiles come with non-zero bounds
+    }
+
+    {  // groups which need the whole formula are rejected by name, and left out of the defaults and of all
+        bool rejected = false;
+        try {
+            ApproxCNFStats::parse_groups("sizes,binary");
+        } catch (std::invalid_argument&) {
+            rejected = true;
+        }
+        CHECK(rejected);
+        for (const std::string spec : { "", "all", "sizes,cg" }) {
+            std::vector<bool> selected = ApproxCNFStats::parse_groups(spec);
+            CHECK(selected[CNFStats::SIZES]);
+            for (unsigned g = CNFStats::CG + 1; g < CNFStats::N_GROUPS; g++) CHECK(!selected[g]);
+        }
+    }
+
+    return check_failures;
+}
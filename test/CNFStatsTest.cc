@@ -0,0 +1,145 @@
+/*************************************************************************************************
+CNFTools -- Copyright (c) 2021, Markus Iser, KIT - Karlsruhe Institute of Technology
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT
+OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ **************************************************************************************************/
+
+#include <chrono>
+#include <map>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "src/util/CNFFormula.h"
+#include "src/util/ResourceLimits.h"
+#include "src/features/CNFStats.h"
+
+#include "test/Check.h"
+
+// Chain of implications x1 -> x2 -> ... -> xn with the unit x1, and a ternary clause per variable
+static std::string chain_formula(const std::string& name, unsigned n) {
+    std::ostringstream out;
+    out << "p cnf " << n << " " << 2 * n - 1 << "\n1 0\n";
+    for (unsigned v = 1; v < n; v++) {
+        out << "-" << v << " " << v + 1 << " 0\n";
+        out << v << " " << v + 1 << " -" << (v * 7) % n + 1 << " 0\n";
+    }
+    return write_file(name, out.str());
+}
+
+// Pigeonhole formula: n + 1 pigeons in n holes, variable p * n + h + 1 places pigeon p in hole h (unsatisfiable)
+static std::string pigeonhole_formula(const std::string& name, unsigned n) {
+    std::ostringstream out;
+    out << "p cnf " << (n + 1) * n << " " << n + 1 + n * n * (n + 1) / 2 << "\n";
+    for (unsigned p = 0; p <= n; p++) {
+        for (unsigned h = 0; h < n; h++) out << p * n + h + 1 << " ";
+        out << "0\n";
+    }
+    for (unsigned h = 0; h < n; h++) {
+        for (unsigned p = 0; p <= n; p++) {
+            for (unsigned q = p + 1; q <= n; q++) out << "-" << p * n + h + 1 << " -" << q * n + h + 1 << " 0\n";
+        }
+    }
+    return write_file(name, out.str());
+}
+
+static std::map<std::string, float> features(const CNFStats& stats) {
+    std::map<std::string, float> result;
+    std::vector<float> record = stats.BaseFeatures();
+    std::vector<std::string> names = stats.FeatureNames();
+    for (unsigned i = 0; i < record.size(); i++) result[names[i]] = record[i];
+    return result;
+}
+
+int main() {
+    CNFFormula formula;
+    formula.readDimacsFromFile(chain_formula("cnfstats_chain.cnf", 2000).c_str());
+
+    {  // propagation runtime is measured in fractional seconds of wallclock time
+        ResourceLimits limits(0, 0);
+        CNFStats stats(formula, limits, 2, "propagation");
+        stats.analyze();
+        std::map<std::string, float> result = features(stats);
+        CHECK(result.count("propagation_runtime") == 1);
+        CHECK(result["propagation_runtime"] > 0);
+        CHECK(result["propagation_runtime"] <= result["base_features_runtime"]);
+        CHECK(result["prop_root_fixed"] == 1);
+    }
+
+    {  // the stage running into the limits is reported, although powerlaw runs before binary
+        ResourceLimits limits(1, 0);
+        CNFStats stats(formula, limits, 1, "sizes,binary,powerlaw");
+        stats.analyze_clauses();
+        stats.analyze_variables();
+        stats.analyze_clause_graph();
+        std::this_thread::sleep_for(std::chrono::milliseconds(1100));
+        bool exceeded = false;
+        try {
+            stats.analyze_power_law();
+        } catch (ResourceLimitsExceeded&) {
+            exceeded = true;
+        }
+        CHECK(exceeded);
+        CHECK(stats.StoppedAt() == "powerlaw");
+        std::map<std::string, float> result = features(stats);
+        CHECK(result.count("clauses") == 1);
+        CHECK(result.count("pl_alpha") == 0);
+    }
+
+    {  // stages without selected groups neither check the limits nor name a group
+        ResourceLimits limits(1, 0);
+        CNFStats stats(formula, limits, 1, "sizes,cg");
+        stats.analyze_clauses();
+        std::this_thread::sleep_for(std::chrono::milliseconds(1100));
+        bool exceeded = false;
+        try {
+            stats.analyze_variables();
+            stats.analyze_power_law();
+        } catch (ResourceLimitsExceeded&) {
+            exceeded = true;
+        }
+        CHECK(!exceeded);
+        try {
+            stats.analyze_clause_graph();
+        } catch (ResourceLimitsExceeded&) {
+            exceeded = true;
+        }
+        CHECK(exceeded);
+        CHECK(stats.StoppedAt() == "cg");
+    }
+
+    {  // bounded solves of an unsatisfiable formula run into conflicts and fix at most all variables
+        CNFFormula pigeons;
+        pigeons.readDimacsFromFile(pigeonhole_formula("cnfstats_pigeons.cnf", 6).c_str());
+        ResourceLimits limits(0, 0);
+        CNFStats stats(pigeons, limits, 1, "cdcl");
+        stats.analyze();
+        std::map<std::string, float> result = features(stats);
+        CHECK(result["cdcl_status"] == 0 || result["cdcl_status"] == 20);
+        CHECK(result["cdcl_conflicts"] > 0);
+        CHECK(result["cdcl_learned_short_fraction"] >= 0 && result["cdcl_learned_short_fraction"] <= 1);
+        CHECK(result["cdcl_learned_size_min"] >= 1);
+        for (const char* round : { "cdcl_fixed_1", "cdcl_fixed_2", "cdcl_fixed_3", "cdcl_fixed_4" }) {
+            CHECK(result.count(round) == 1);
+            CHECK(result[round] >= 0 && result[round] <= 1);  // fraction of the variables
+        }
+        CHECK(result["cdcl_fixed_1"] <= result["cdcl_fixed_2"] && result["cdcl_fixed_2"] <= result["cdcl_fixed_3"]);
+        CHECK(result["cdcl_fixed_3"] <= result["cdcl_fixed_4"]);
+    }
+
+    return check_failures;
+}
@@ -0,0 +1,57 @@
+/*************************************************************************************************
+CNFTools -- Copyright (c) 2021, Markus Iser, KIT - Karlsruhe Institute of Technology
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT
+OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ **************************************************************************************************/
+
+#ifndef TEST_CHECK_H_
+#define TEST_CHECK_H_
+
+#include <math.h>
+
+#include <cstdio>
+#include <string>
+
+/**
+ * Minimal assertions for the unit tests: failed checks are reported and counted,
+ * and the test executable returns the number of failed checks
+ */
+static unsigned check_failures = 0;
+
+#define CHECK(condition) do { \
+    if (!(condition)) { \
+        std::fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #condition); \
+        ++check_failures; \
+    } \
+} while (0)
+
+#define CHECK_NEAR(value, expected, tolerance) do { \
+    const double value_ = (value), expected_ = (expected); \
+    if (!(fabs(value_ - expected_) <= (tolerance))) { \
+        std::fprintf(stderr, "%s:%d: check failed: %s = %g, expected %g\n", __FILE__, __LINE__, #value, value_, expected_); \
+        ++check_failures; \
+    } \
+} while (0)
+
+// Writes content to a file in the working directory and returns its name
+inline std::string write_file(const std::string& name, const std::string& content) {
+    FILE* file = std::fopen(name.c_str(), "w");
+    std::fputs(content.c_str(), file);
+    std::fclose(file);
+    return name;
+}
+
+#endif  // TEST_CHECK_H_
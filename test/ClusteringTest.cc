@@ -0,0 +1,82 @@
+/*************************************************************************************************
+CNFTools -- Copyright (c) 2021, Markus Iser, KIT - Karlsruhe Institute of Technology
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT
+OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ **************************************************************************************************/
+
+#include <utility>
+#include <vector>
+
+#include "src/util/CSRGraph.h"
+#include "src/util/ResourceLimits.h"
+#include "src/features/Clustering.h"
+
+#include "test/Check.h"
+
+static CSRGraph graph(size_t n, const std::vector<std::pair<unsigned, unsigned>>& edges, const ResourceLimits& limits) {
+    std::vector<std::vector<unsigned>> neighbours(n);
+    for (auto edge : edges) {
+        neighbours[edge.first].push_back(edge.second);
+        neighbours[edge.second].push_back(edge.first);
+    }
+    return CSRGraph::build(n, 1, limits, [&] (unsigned, size_t v, std::vector<unsigned>* row) {
+        row->insert(row->end(), neighbours[v].begin(), neighbours[v].end());
+    });
+}
+
+int main() {
+    ResourceLimits limits(0, 0);
+
+    {  // a clique of four vertices 0 .. 3 with the path 0 - 4 - 5 attached
+        CSRGraph g = graph(6, { { 0, 1 }, { 0, 2 }, { 0, 3 }, { 1, 2 }, { 1, 3 }, { 2, 3 }, { 0, 4 }, { 4, 5 } }, limits);
+        for (unsigned threads : { 1, 3 }) {
+            Clustering clustering(g, limits, threads);
+            clustering.analyze();
+            CHECK(clustering.exact);
+            CHECK(clustering.wedges == 16);
+            CHECK(clustering.triangles == 4);
+            CHECK(clustering.triangles_error == 0);
+            CHECK_NEAR(clustering.transitivity, 0.75, 1e-9);
+            CHECK(clustering.transitivity_error == 0);
+            // local coefficients 0.5 (vertex 0), 1 (vertices 1 .. 3) and 0 (vertex 4), vertex 5 has degree one
+            CHECK(clustering.coefficients.size() == 5);
+            CHECK_NEAR(clustering.coefficients.mean(), 0.7, 1e-6);
+            CHECK(clustering.coefficients.min() == 0 && clustering.coefficients.max() == 1);
+        }
+    }
+
+    {  // trees have no triangles
+        std::vector<std::pair<unsigned, unsigned>> edges;
+        for (unsigned v = 1; v < 100; v++) edges.emplace_back((v - 1) / 3, v);
+        CSRGraph tree = graph(100, edges, limits);
+        Clustering clustering(tree, limits, 2);
+        clustering.analyze();
+        CHECK(clustering.triangles == 0);
+        CHECK(clustering.transitivity == 0);
+        CHECK(clustering.coefficients.max() == 0);
+    }
+
+    {  // empty graph
+        CSRGraph g;
+        Clustering clustering(g, limits, 1);
+        clustering.analyze();
+        CHECK(clustering.wedges == 0);
+        CHECK(clustering.transitivity == 0);
+        CHECK(clustering.coefficients.size() == 0);
+    }
+
+    return check_failures;
+}
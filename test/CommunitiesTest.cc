@@ -0,0 +1,87 @@
+/*************************************************************************************************
+CNFTools -- Copyright (c) 2021, Markus Iser, KIT - Karlsruhe Institute of Technology
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT
+OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ **************************************************************************************************/
+
+#include <utility>
+#include <vector>
+
+#include "src/util/CSRGraph.h"
+#include "src/util/ResourceLimits.h"
+#include "src/features/Communities.h"
+
+#include "test/Check.h"
+
+typedef std::vector<std::pair<unsigned, unsigned>> Edges;
+
+static CSRGraph graph(size_t n, const Edges& edges, const ResourceLimits& limits) {
+    std::vector<std::vector<unsigned>> neighbours(n);
+    for (auto edge : edges) {
+        neighbours[edge.first].push_back(edge.second);
+        neighbours[edge.second].push_back(edge.first);
+    }
+    return CSRGraph::build(n, 1, limits, [&] (unsigned, size_t v, std::vector<unsigned>* row) {
+        row->insert(row->end(), neighbours[v].begin(), neighbours[v].end());
+    });
+}
+
+// k cliques of the given size on consecutive vertices, clique i connected to clique i + 1 (mod k) by one edge if ring
+static Edges cliques(unsigned k, unsigned size, bool ring) {
+    Edges edges;
+    for (unsigned c = 0; c < k; c++) {
+        for (unsigned u = 0; u < size; u++) {
+            for (unsigned v = u + 1; v < size; v++) edges.emplace_back(c * size + u, c * size + v);
+        }
+        if (ring) edges.emplace_back(c * size, ((c + 1) % k) * size + 1);
+    }
+    return edges;
+}
+
+int main() {
+    ResourceLimits limits(0, 0);
+
+    {  // two disjoint cliques: modularity 2 * (1/2 - 1/4), plus an isolated vertex which is not counted
+        CSRGraph g = graph(11, cliques(2, 5, false), limits);
+        Louvain louvain(g, limits, 1);
+        louvain.analyze();
+        CHECK(louvain.communities == 2);
+        CHECK_NEAR(louvain.modularity, 0.5, 1e-6);
+        CHECK(louvain.sizes.size() == 2 && louvain.sizes.min() == 5 && louvain.sizes.max() == 5);
+    }
+
+    {  // ring of six cliques of size five: m = 66, each community has 10 internal edges and degree 22
+        CSRGraph g = graph(30, cliques(6, 5, true), limits);
+        const double expected = 6 * (10.0 / 66 - (22.0 / 132) * (22.0 / 132));
+        for (unsigned threads : { 1, 3 }) {
+            Louvain louvain(g, limits, threads);
+            louvain.analyze();
+            CHECK(louvain.communities == 6);
+            CHECK_NEAR(louvain.modularity, expected, 1e-6);
+            CHECK(louvain.levels >= 1);
+        }
+    }
+
+    {  // a single clique is one community with modularity zero
+        CSRGraph g = graph(6, cliques(1, 6, false), limits);
+        Louvain louvain(g, limits, 1);
+        louvain.analyze();
+        CHECK(louvain.communities == 1);
+        CHECK_NEAR(louvain.modularity, 0, 1e-6);
+    }
+
+    return check_failures;
+}
@@ -0,0 +1,89 @@
+/*************************************************************************************************
+CNFTools -- Copyright (c) 2021, Markus Iser, KIT - Karlsruhe Institute of Technology
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT
+OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ **************************************************************************************************/
+
+#include <math.h>
+
+#include <limits>
+#include <vector>
+
+#include "src/features/Util.h"
+
+#include "test/Check.h"
+
+int main() {
+    {  // statistics of a small integral distribution
+        Distribution<unsigned> distribution;
+        for (unsigned value : { 4, 1, 3, 1, 2, 1 }) distribution.add(value);
+        CHECK(distribution.size() == 6);
+        CHECK_NEAR(distribution.mean(), 2, 1e-6);
+        CHECK_NEAR(distribution.variance(), 8.0 / 6, 1e-6);
+        CHECK(distribution.min() == 1 && distribution.max() == 4);
+        CHECK_NEAR(distribution.entropy(), -0.5 * log2(0.5) - 3 * (1.0 / 6) * log2(1.0 / 6), 1e-6);
+        CHECK(distribution.quantile(0.5) == 1);
+        CHECK(distribution.quantile(0.9) == 3);
+        CHECK(distribution.quantile(1) == 4);
+    }
+
+    {  // merged parts equal the whole, and the vectorized summary equals the streaming one
+        std::vector<unsigned> samples;
+        for (unsigned i = 0; i < 1000; i++) samples.push_back((i * 7919) % 101);
+        Distribution<unsigned> whole, left, right;
+        for (size_t i = 0; i < samples.size(); i++) {
+            whole.add(samples[i]);
+            (i < 300 ? left : right).add(samples[i]);
+        }
+        left.merge(right);
+        Distribution<unsigned> summary = summarize(samples);
+        for (const Distribution<unsigned>* d : { &left, &summary }) {
+            CHECK(d->size() == whole.size());
+            CHECK_NEAR(d->mean(), whole.mean(), 1e-6);
+            CHECK_NEAR(d->variance(), whole.variance(), 1e-3);
+            CHECK_NEAR(d->entropy(), whole.entropy(), 1e-6);
+            CHECK(d->quantile(0.9) == whole.quantile(0.9));
+        }
+    }
+
+    {  // the histogram does not grow with the maximum value
+        Distribution<unsigned> distribution;
+        distribution.add(0);
+        distribution.add(1000000000);
+        CHECK(distribution.bins() == 2);
+        CHECK_NEAR(distribution.entropy(), 1, 1e-6);
+        CHECK(distribution.quantile(0) == 0);
+        CHECK(distribution.quantile(1) == 1000000000);
+        Distribution<unsigned> summary = summarize(std::vector<unsigned> { 3, 4000000000u, 3 });
+        CHECK(summary.bins() < 16);
+        CHECK(summary.quantile(0.5) == 3);
+        CHECK(summary.max() == 4000000000u);
+    }
+
+    {  // negative, infinite and NaN samples have bins of their own
+        Distribution<float> distribution;
+        distribution.add(-0.5);
+        distribution.add(0.3);
+        distribution.add(std::numeric_limits<float>::quiet_NaN());
+        distribution.add(std::numeric_limits<float>::infinity());
+        CHECK(distribution.size() == 4);
+        CHECK(distribution.bins() < 16);
+        CHECK_NEAR(distribution.entropy(), 2, 1e-6);
+        CHECK(distribution.min() == -0.5f);
+    }
+
+    return check_failures;
+}
@@ -0,0 +1,77 @@
+/*************************************************************************************************
+CNFTools -- Copyright (c) 2021, Markus Iser, KIT - Karlsruhe Institute of Technology
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT
+OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ **************************************************************************************************/
+
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+#include <algorithm>
+
+#include "src/util/FastHash.h"
+#include "src/util/GBDHash.h"
+
+#include "test/Check.h"
+
+int main() {
+    {  // whitespace, comments, header and line breaks do not change the identifiers, one flipped literal does
+        const std::string plain = write_file("fasthash_plain.cnf", "p cnf 4 3\n1 -2 0\n2 3 -4 0\n-1 4 0\n");
+        const std::string formatted = write_file("fasthash_formatted.cnf",
+            "c comment\np  cnf 4   3\n\n  1\t-2  0\nc another comment\n2 3\n -4 0 -1\n4 0\n\n");
+        const std::string flipped = write_file("fasthash_flipped.cnf", "p cnf 4 3\n1 -2 0\n2 3 4 0\n-1 4 0\n");
+        CHECK(fast_hash_from_dimacs(plain.c_str()) == fast_hash_from_dimacs(formatted.c_str()));
+        CHECK(gbd_hash_from_dimacs(plain.c_str()) == gbd_hash_from_dimacs(formatted.c_str()));
+        CHECK(fast_hash_from_dimacs(plain.c_str()) != fast_hash_from_dimacs(flipped.c_str()));
+        CHECK(fast_hash_from_dimacs(plain.c_str()).size() == 32);
+        std::pair<std::string, std::string> both = gbd_and_fast_hash_from_dimacs(formatted.c_str());
+        CHECK(both.first == gbd_hash_from_dimacs(plain.c_str()));
+        CHECK(both.second == fast_hash_from_dimacs(plain.c_str()));
+    }
+
+    {  // the digest does not depend on how the input is split into calls (stripes, blocks and the tail)
+        std::mt19937 rng(1);
+        std::string input(5000, 0);
+        for (char& c : input) c = static_cast<char>(rng());
+        for (size_t length : { 0, 1, 63, 64, 65, 1023, 1024, 1025, 5000 }) {
+            FastHash128 whole;
+            whole.process(input.data(), length);
+            const std::pair<uint64_t, uint64_t> expected = whole.finish();
+            for (size_t piece : { 1, 7, 64, 100 }) {
+                FastHash128 pieces;
+                for (size_t pos = 0; pos < length; pos += piece) {
+                    pieces.process(input.data() + pos, std::min(piece, length - pos));
+                }
+                CHECK(pieces.finish() == expected);
+            }
+        }
+    }
+
+    {  // prefixes of different lengths get different digests
+        std::string input(300, 'a');
+        std::vector<std::pair<uint64_t, uint64_t>> digests;
+        for (size_t length = 0; length <= input.size(); length++) {
+            FastHash128 hash;
+            hash.process(input.data(), length);
+            digests.push_back(hash.finish());
+        }
+        std::sort(digests.begin(), digests.end());
+        CHECK(std::unique(digests.begin(), digests.end()) == digests.end());
+    }
+
+    return check_failures;
+}
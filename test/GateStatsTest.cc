@@ -0,0 +1,98 @@
+/*************************************************************************************************
+CNFTools -- Copyright (c) 2021, Markus Iser, KIT - Karlsruhe Institute of Technology
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT
+OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ **************************************************************************************************/
+
+#include <cstdlib>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "src/util/CNFFormula.h"
+#include "src/util/ResourceLimits.h"
+#include "src/features/GateStats.h"
+
+#include "test/Check.h"
+
+static Lit lit(int dimacs) {
+    return Lit(std::abs(dimacs), dimacs < 0);
+}
+
+// Tseitin encoding of the and-gate (or-gate if negated) output <-> (a & b), in dimacs literals
+static void tseitin(CNFFormula* formula, int output, int a, int b, bool negated) {
+    const int o = negated ? -output : output;
+    const int sign = negated ? -1 : 1;
+    formula->readClause({ lit(-o), lit(sign * a) });
+    formula->readClause({ lit(-o), lit(sign * b) });
+    formula->readClause({ lit(o), lit(-sign * a), lit(-sign * b) });
+}
+
+static std::map<std::string, float> features(GateStats* stats) {
+    std::map<std::string, float> result;
+    std::vector<float> record = stats->GateFeatures();
+    std::vector<std::string> names = GateStats::GateFeatureNames();
+    CHECK(record.size() == names.size());
+    for (unsigned i = 0; i < record.size(); i++) result[names[i]] = record[i];
+    return result;
+}
+
+int main() {
+    ResourceLimits limits(0, 0);
+
+    {  // inputs 1..4, gates 5 = 1 & 2, 6 = 5 | 3, 7 = 5 & 4, root 8 = 6 & 7: gate 5 reconverges at the root
+        CNFFormula formula;
+        tseitin(&formula, 5, 1, 2, false);
+        tseitin(&formula, 6, 5, 3, true);
+        tseitin(&formula, 7, 5, 4, false);
+        tseitin(&formula, 8, 6, 7, false);
+        formula.readClause({ lit(8) });
+        GateStats stats(formula, limits);
+        stats.analyze(1, 0);
+        std::map<std::string, float> result = features(&stats);
+        CHECK(result["n_gates"] == 4);
+        CHECK(result["n_none"] == 4);
+        CHECK(result["n_roots"] == 1);
+        // width profile over the levels (longest path from the inputs): 5 | 6, 7 | 8
+        CHECK(result["gate_depth"] == 3);
+        CHECK(result["gate_width_min"] == 1);
+        CHECK(result["gate_width_max"] == 2);
+        CHECK_NEAR(result["gate_width_mean"], 4.0 / 3, 1e-6);
+        CHECK(result["gate_fanout_max"] == 2);
+        CHECK(result["gate_fanout_min"] == 0);
+        CHECK(result["gate_stems"] == 1);
+        CHECK(result["gate_reconvergent"] == 1);
+    }
+
+    {  // same shape without the shared gate: 5 = 1 & 2, 6 = 3 | 4, root 7 = 5 & 6
+        CNFFormula formula;
+        tseitin(&formula, 5, 1, 2, false);
+        tseitin(&formula, 6, 3, 4, true);
+        tseitin(&formula, 7, 5, 6, false);
+        formula.readClause({ lit(7) });
+        GateStats stats(formula, limits);
+        stats.analyze(1, 0);
+        std::map<std::string, float> result = features(&stats);
+        CHECK(result["n_gates"] == 3);
+        CHECK(result["gate_depth"] == 2);
+        CHECK(result["gate_width_min"] == 1);
+        CHECK(result["gate_width_max"] == 2);
+        CHECK(result["gate_stems"] == 0);
+        CHECK(result["gate_reconvergent"] == 0);
+    }
+
+    return check_failures;
+}
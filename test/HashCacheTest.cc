@@ -0,0 +1,90 @@
+/*************************************************************************************************
+CNFTools -- Copyright (c) 2021, Markus Iser, KIT - Karlsruhe Institute of Technology
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT
+OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ **************************************************************************************************/
+
+#include <fstream>
+#include <iterator>
+#include <string>
+
+#include "src/util/HashCache.h"
+
+#include "test/Check.h"
+
+static std::string read_file(const std::string& name) {
+    std::ifstream in(name);
+    return std::string(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+}
+
+int main() {
+    const std::string hash = "0123456789abcdef0123456789abcdef";
+    FileKey a, b, c;
+    a.inode = 1;
+    b.inode = 2;
+    c.inode = 3;
+    std::string found;
+
+    {  // last line truncated in the middle of the hash (interrupted write)
+        const std::string path = write_file("hashcache_truncated.log",
+            "0 1 0 0 " + hash + "\n0 2 0 0 " + hash.substr(0, 20));
+        {
+            HashCache cache(path);
+            CHECK(cache.size() == 1);
+            CHECK(cache.lookup(a, &found) && found == hash);
+            CHECK(!cache.lookup(b, &found));
+            cache.insert(c, hash);
+        }
+        // the new entry starts on a fresh line and survives a reload
+        CHECK(read_file(path).find("\n0 3 0 0 " + hash + "\n") != std::string::npos);
+        HashCache cache(path);
+        CHECK(cache.size() == 2);
+        CHECK(cache.lookup(c, &found) && found == hash);
+        CHECK(!cache.lookup(b, &found));
+    }
+
+    {  // complete hash but no newline: the write might have been interrupted before the newline
+        const std::string path = write_file("hashcache_unterminated.log", "0 1 0 0 " + hash);
+        HashCache cache(path);
+        CHECK(cache.size() == 0);
+    }
+
+    {  // malformed lines
+        const std::string path = write_file("hashcache_malformed.log",
+            "0 1 0 0 " + hash.substr(0, 31) + "\n"
+            "0 2 0 0 " + hash + " trailing\n"
+            "0 3 0 0 0123456789ABCDEF0123456789ABCDEF\n"
+            "0 4 0\n"
+            "0 5 0 0 " + hash + "\n");
+        HashCache cache(path);
+        CHECK(cache.size() == 1);
+        FileKey e;
+        e.inode = 5;
+        CHECK(cache.lookup(e, &found) && found == hash);
+    }
+
+    {  // cache hit and miss via cached_hash
+        const std::string file = write_file("hashcache_file.txt", "content\n");
+        HashCache cache("hashcache_hit.log");
+        unsigned calls = 0;
+        auto hash_function = [&] (const char*) { ++calls; return hash; };
+        CHECK(cached_hash(file.c_str(), &cache, hash_function) == hash);
+        CHECK(cached_hash(file.c_str(), &cache, hash_function) == hash);
+        CHECK(calls == 1);
+    }
+
+    return check_failures;
+}
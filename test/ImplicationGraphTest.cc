@@ -0,0 +1,89 @@
+/*************************************************************************************************
+CNFTools -- Copyright (c) 2021, Markus Iser, KIT - Karlsruhe Institute of Technology
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT
+OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ **************************************************************************************************/
+
+#include <cstdlib>
+#include <initializer_list>
+
+#include "src/util/CNFFormula.h"
+#include "src/util/ResourceLimits.h"
+#include "src/features/ImplicationGraph.h"
+
+#include "test/Check.h"
+
+static CNFFormula formula(std::initializer_list<std::initializer_list<int>> clauses) {
+    CNFFormula result;
+    for (const auto& clause : clauses) {
+        Cl lits;
+        for (int lit : clause) lits.push_back(Lit(abs(lit), lit < 0));
+        result.readClause(lits.begin(), lits.end());
+    }
+    return result;
+}
+
+int main() {
+    ResourceLimits limits(0, 0);
+
+    {  // a cycle of implications makes its literals equivalent (and their negations)
+        CNFFormula cnf = formula({ { -1, 2 }, { -2, 3 }, { -3, 1 }, { 4, 5, 6 } });
+        ImplicationGraph graph(cnf, limits);
+        graph.analyze();
+        CHECK(!graph.unsat);
+        CHECK(graph.classes == 1);
+        CHECK(graph.equivalent_literals == 2);
+        CHECK(graph.depth == 0);
+        CHECK(graph.sizes.size() == 1 && graph.sizes.max() == 3);
+    }
+
+    {  // a chain of implications has no equivalences, its depth is the number of edges
+        CNFFormula cnf = formula({ { -1, 2 }, { -2, 3 }, { -3, 4 } });
+        ImplicationGraph graph(cnf, limits);
+        graph.analyze();
+        CHECK(!graph.unsat);
+        CHECK(graph.classes == 0);
+        CHECK(graph.equivalent_literals == 0);
+        CHECK(graph.depth == 3);
+    }
+
+    {  // a unit adds the edge from its negation, such that -2 -> -1 -> 1 -> 2
+        CNFFormula cnf = formula({ { 1 }, { -1, 2 } });
+        ImplicationGraph graph(cnf, limits);
+        graph.analyze();
+        CHECK(graph.depth == 3);
+    }
+
+    {  // a literal equivalent to its negation
+        CNFFormula cnf = formula({ { 1, 2 }, { -1, 2 }, { 1, -2 }, { -1, -2 } });
+        ImplicationGraph graph(cnf, limits);
+        graph.analyze();
+        CHECK(graph.unsat);
+    }
+
+    {  // a long chain does not overflow the (explicit) stack
+        CNFFormula cnf;
+        for (unsigned v = 1; v < 100000; v++) cnf.readClause({ Lit(v, true), Lit(v + 1, false) });
+        cnf.readClause({ Lit(100000, true), Lit(1, false) });
+        ImplicationGraph graph(cnf, limits);
+        graph.analyze();
+        CHECK(!graph.unsat);
+        CHECK(graph.classes == 1);
+        CHECK(graph.equivalent_literals == 99999);
+    }
+
+    return check_failures;
+}
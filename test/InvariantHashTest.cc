@@ -0,0 +1,107 @@
+/*************************************************************************************************
+CNFTools -- Copyright (c) 2021, Markus Iser, KIT - Karlsruhe Institute of Technology
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT
+OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ **************************************************************************************************/
+
+#include <cstdlib>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <algorithm>
+
+#include "src/util/CNFFormula.h"
+#include "src/util/InvariantHash.h"
+
+#include "test/Check.h"
+
+typedef std::vector<std::vector<int>> Clauses;
+
+// Random 3-CNF over the given number of variables (three distinct variables per clause)
+static Clauses random_formula(unsigned vars, unsigned n, std::mt19937* rng) {
+    Clauses clauses(n);
+    for (std::vector<int>& clause : clauses) {
+        while (clause.size() < 3) {
+            int var = 1 + (*rng)() % vars;
+            bool fresh = true;
+            for (int lit : clause) fresh &= abs(lit) != var;
+            if (fresh) clause.push_back((*rng)() & 1 ? -var : var);
+        }
+    }
+    return clauses;
+}
+
+static std::string dimacs(const std::string& name, unsigned vars, const Clauses& clauses) {
+    std::ostringstream out;
+    out << "p cnf " << vars << " " << clauses.size() << "\n";
+    for (const std::vector<int>& clause : clauses) {
+        for (int lit : clause) out << lit << " ";
+        out << "0\n";
+    }
+    return write_file(name, out.str());
+}
+
+int main() {
+    std::mt19937 rng(1);
+    const unsigned vars = 200;
+    const Clauses clauses = random_formula(vars, 800, &rng);
+    const std::string original = dimacs("invariant_original.cnf", vars, clauses);
+
+    Clauses shuffled = clauses;
+    std::shuffle(shuffled.begin(), shuffled.end(), rng);
+    for (std::vector<int>& clause : shuffled) std::shuffle(clause.begin(), clause.end(), rng);
+    const std::string permuted = dimacs("invariant_permuted.cnf", vars, shuffled);
+
+    std::vector<int> renaming(vars + 1);
+    for (unsigned v = 0; v <= vars; v++) renaming[v] = v;
+    std::shuffle(renaming.begin() + 1, renaming.end(), rng);
+    Clauses renamed = shuffled;
+    for (std::vector<int>& clause : renamed) {
+        for (int& lit : clause) lit = lit < 0 ? -renaming[-lit] : renaming[lit];
+    }
+    const std::string renamed_file = dimacs("invariant_renamed.cnf", vars, renamed);
+
+    Clauses flipped = clauses;
+    flipped[17][1] = -flipped[17][1];
+    const std::string flipped_file = dimacs("invariant_flipped.cnf", vars, flipped);
+
+    {  // clause and literal order do not matter, polarity and variable names do
+        const std::string hash = permutation_invariant_hash_from_dimacs(original.c_str());
+        CHECK(hash.size() == 32);
+        CHECK(permutation_invariant_hash_from_dimacs(permuted.c_str()) == hash);
+        CHECK(permutation_invariant_hash_from_dimacs(flipped_file.c_str()) != hash);
+        CHECK(permutation_invariant_hash_from_dimacs(renamed_file.c_str()) != hash);
+    }
+
+    {  // duplicate literals are ignored
+        const std::string single = write_file("invariant_single.cnf", "p cnf 3 2\n1 -2 0\n3 0\n");
+        const std::string duplicate = write_file("invariant_duplicate.cnf", "p cnf 3 2\n3 3 0\n-2 1 -2 0\n");
+        CHECK(permutation_invariant_hash_from_dimacs(single.c_str()) == permutation_invariant_hash_from_dimacs(duplicate.c_str()));
+    }
+
+    {  // renaming of variables (and reordering) does not matter, a flipped literal does
+        const std::string hash = renaming_invariant_hash_from_dimacs(original.c_str());
+        CHECK(renaming_invariant_hash_from_dimacs(permuted.c_str()) == hash);
+        CHECK(renaming_invariant_hash_from_dimacs(renamed_file.c_str()) == hash);
+        CHECK(renaming_invariant_hash_from_dimacs(flipped_file.c_str()) != hash);
+        CNFFormula formula;
+        formula.readDimacsFromFile(renamed_file.c_str());
+        CHECK(renaming_invariant_hash(formula) == hash);
+    }
+
+    return check_failures;
+}
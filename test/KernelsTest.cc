@@ -0,0 +1,88 @@
+/*************************************************************************************************
+CNFTools -- Copyright (c) 2021, Markus Iser, KIT - Karlsruhe Institute of Technology
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT
+OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ **************************************************************************************************/
+
+#include <random>
+#include <vector>
+
+#include "src/features/Kernels.h"
+
+#include "test/Check.h"
+
+// Kernels agree with the scalar loops for all lengths around the vector widths (built with and without -mavx2)
+int main() {
+    std::mt19937 rng(7);
+
+    for (unsigned n = 0; n < 40; n++) {
+        Cl clause;
+        unsigned expected = 0;
+        for (unsigned i = 0; i < n; i++) {
+            clause.push_back(Lit(rng() % 1000, rng() & 1));
+            if (clause.back().sign()) ++expected;
+        }
+        CHECK(count_negative(clause) == expected);
+    }
+
+    for (size_t n : { 1, 3, 4, 7, 8, 9, 15, 16, 17, 100, 1000, 100000 }) {
+        for (uint32_t range : { 2u, 100u, 4000000000u }) {
+            std::vector<uint32_t> data(n);
+            for (uint32_t& x : data) x = rng() % range;
+            uint32_t min = data[0], max = data[0];
+            uint64_t sum = 0;
+            for (uint32_t x : data) {
+                min = std::min(min, x);
+                max = std::max(max, x);
+                sum += x;
+            }
+            MinMaxSum mms = min_max_sum(data.data(), n);
+            CHECK(mms.min == min && mms.max == max && mms.sum == sum);
+
+            const double mean = static_cast<double>(sum) / n;
+            double deviation = 0;
+            for (uint32_t x : data) deviation += (x - mean) * (x - mean);
+            // the AVX2 path rounds 2^31 - mean, i.e., each deviation is off by up to 2^-22
+            CHECK_NEAR(squared_deviation(data.data(), n, mean), deviation, 1e-9 * deviation + 1e-6 * n);
+
+            if (range <= 100) {
+                std::vector<uint64_t> expected(max + 1, 0), actual(2, 1);  // counts are added to the given histogram
+                for (uint32_t x : data) ++expected[x];
+                expected[0] += 1;
+                expected[1] += 1;
+                count_frequencies(data.data(), n, max, &actual);
+                CHECK(actual == expected);
+            }
+        }
+    }
+
+    for (unsigned round = 0; round < 200; round++) {
+        std::vector<uint32_t> a, b, expected, actual;
+        const unsigned universe = 8 + rng() % 300;
+        for (uint32_t x = 0; x < universe; x++) {
+            bool in_a = rng() % 3 == 0, in_b = rng() % (round % 2 ? 2 : 9) == 0;
+            if (in_a) a.push_back(x);
+            if (in_b) b.push_back(x);
+            if (in_a && in_b) expected.push_back(x);
+        }
+        size_t count = intersect(a.data(), a.size(), b.data(), b.size(), [&actual] (uint32_t x) { actual.push_back(x); });
+        std::sort(actual.begin(), actual.end());
+        CHECK(count == expected.size());
+        CHECK(actual == expected);
+    }
+
+    return check_failures;
+}
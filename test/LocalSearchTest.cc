@@ -0,0 +1,91 @@
+/*************************************************************************************************
+CNFTools -- Copyright (c) 2021, Markus Iser, KIT - Karlsruhe Institute of Technology
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT
+OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ **************************************************************************************************/
+
+#include <random>
+#include <vector>
+
+#include "src/util/CNFFormula.h"
+#include "src/util/ResourceLimits.h"
+#include "src/features/LocalSearch.h"
+
+#include "test/Check.h"
+
+// Random 3-CNF with n variables and the given number of clauses which are all satisfied by a planted assignment
+static CNFFormula planted_formula(unsigned n, unsigned clauses, std::mt19937* rng) {
+    std::vector<bool> planted(n + 1);
+    for (unsigned v = 1; v <= n; v++) planted[v] = (*rng)() & 1;
+    CNFFormula formula;
+    while (formula.nClauses() < clauses) {
+        Cl clause;
+        bool satisfied = false;
+        for (unsigned k = 0; k < 3; k++) {
+            const unsigned v = 1 + (*rng)() % n;
+            const bool negative = (*rng)() & 1;
+            satisfied |= planted[v] != negative;
+            clause.push_back(Lit(v, negative));
+        }
+        if (satisfied) formula.readClause(clause.begin(), clause.end());
+    }
+    return formula;
+}
+
+int main() {
+    ResourceLimits limits(0, 0);
+    std::mt19937 rng(1);
+
+    {  // satisfiable formula: all probes find an assignment with no unsatisfied clause
+        CNFFormula formula = planted_formula(200, 600, &rng);
+        LocalSearch search(formula, limits, 2);
+        search.analyze(4, 1 << 16);
+        CHECK(search.probes.size() == 4);
+        for (const LocalSearch::Probe& probe : search.probes) {
+            CHECK(probe.solved);
+            CHECK(probe.best_unsat == 0);
+        }
+    }
+
+    {  // results do not depend on the number of threads
+        CNFFormula formula = planted_formula(300, 1300, &rng);
+        LocalSearch single(formula, limits, 1), parallel(formula, limits, 3);
+        single.analyze(6, 1 << 14);
+        parallel.analyze(6, 1 << 14);
+        for (unsigned i = 0; i < 6; i++) {
+            CHECK(single.probes[i].best_unsat == parallel.probes[i].best_unsat);
+            CHECK(single.probes[i].best_flip == parallel.probes[i].best_flip);
+            CHECK(single.probes[i].mean_unsat == parallel.probes[i].mean_unsat);
+        }
+    }
+
+    {  // unsatisfiable formula: at least one clause stays unsatisfied
+        CNFFormula formula;
+        formula.readClause({ Lit(1, false), Lit(2, false) });
+        formula.readClause({ Lit(1, false), Lit(2, true) });
+        formula.readClause({ Lit(1, true), Lit(2, false) });
+        formula.readClause({ Lit(1, true), Lit(2, true) });
+        LocalSearch search(formula, limits, 1);
+        search.analyze(2, 1000);
+        for (const LocalSearch::Probe& probe : search.probes) {
+            CHECK(!probe.solved);
+            CHECK(probe.best_unsat == 1);
+            CHECK(probe.mean_unsat >= 1);
+        }
+    }
+
+    return check_failures;
+}
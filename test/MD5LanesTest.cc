@@ -0,0 +1,107 @@
+/*************************************************************************************************
+CNFTools -- Copyright (c) 2021, Markus Iser, KIT - Karlsruhe Institute of Technology
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT
+OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ **************************************************************************************************/
+
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "lib/md5/md5.h"
+
+#include "src/util/GBDHash.h"
+#include "src/util/HashBatch.h"
+
+#include "test/Check.h"
+
+// Normalized clause text of the given length (length != 2): one clause of literals 1 (and one literal 10 for the parity)
+static std::string normalized_text(unsigned length) {
+    if (length == 0) return "";
+    std::string text;
+    unsigned rest = length - 1;
+    if (rest % 2 == 1) {
+        text += "10 ";
+        rest -= 3;
+    }
+    for (; rest > 0; rest -= 2) text += "1 ";
+    return text + "0";
+}
+
+static std::string md5_of(const std::string& text) {
+    md5::md5_t md5;
+    md5.process(text.data(), text.size());
+    return md5_string(md5);
+}
+
+int main() {
+    // lengths around the padding boundaries (55 / 56 bytes of the last block), block sizes and the lane staging buffer
+    std::vector<std::string> files;
+    std::vector<std::string> expected;
+    for (unsigned length : { 0, 1, 3, 54, 55, 56, 57, 63, 64, 65, 119, 120, 121, 128, 4095, 4096, 4097, 20000 }) {
+        const std::string text = normalized_text(length);
+        CHECK(text.size() == length);
+        files.push_back(write_file("lanes_" + std::to_string(length) + ".cnf", "c length " + std::to_string(length)
+            + "\np cnf 10 1\n" + text + "\n"));
+        expected.push_back(gbd_hash_from_dimacs(files.back().c_str()));
+        CHECK(expected.back() == md5_of(text));
+    }
+
+    {  // more files than lanes, such that lanes finish early and sit idle at the end, and one missing file
+        std::vector<std::string> inputs = files;
+        inputs.insert(inputs.begin() + 5, "lanes_missing.cnf");
+        std::map<size_t, std::string> results;
+        std::vector<size_t> errors;
+        gbd_hash_from_dimacs_lanes(inputs, [&] (size_t i, const std::string& hash) {
+            CHECK(results.count(i) == 0);
+            results[i] = hash;
+        }, [&] (size_t i, const std::string&) {
+            errors.push_back(i);
+        });
+        CHECK(errors.size() == 1 && errors[0] == 5);
+        CHECK(results.size() == files.size());
+        for (size_t i = 0; i < inputs.size(); i++) if (i != 5) {
+            CHECK(results[i] == expected[i < 5 ? i : i - 1]);
+        }
+    }
+
+    {  // fewer files than lanes
+        std::vector<std::string> inputs = { files[3], files[5] };
+        std::map<size_t, std::string> results;
+        gbd_hash_from_dimacs_lanes(inputs, [&] (size_t i, const std::string& hash) { results[i] = hash; },
+            [&] (size_t, const std::string&) { CHECK(false); });
+        CHECK(results.size() == 2 && results[0] == expected[3] && results[1] == expected[5]);
+    }
+
+    {  // batch mode over several groups of files on two threads (files without a trailing newline)
+        std::vector<std::string> inputs = files;
+        std::vector<std::string> hashes = expected;
+        for (unsigned i = 0; i < 100; i++) {
+            inputs.push_back(write_file("lanes_batch_" + std::to_string(i) + ".cnf", normalized_text(2 * i + 1)));
+            hashes.push_back(md5_of(normalized_text(2 * i + 1)));
+        }
+        std::ostringstream out;
+        CHECK(gbd_hash_batch_lanes(inputs, 2, out) == 0);
+        std::map<std::string, std::string> results;
+        std::istringstream lines(out.str());
+        for (std::string hash, path; lines >> hash >> path; ) results[path] = hash;
+        CHECK(results.size() == inputs.size());
+        for (size_t i = 0; i < inputs.size(); i++) CHECK(results[inputs[i]] == hashes[i]);
+    }
+
+    return check_failures;
+}
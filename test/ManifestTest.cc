@@ -0,0 +1,67 @@
+/*************************************************************************************************
+CNFTools -- Copyright (c) 2021, Markus Iser, KIT - Karlsruhe Institute of Technology
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT
+OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ **************************************************************************************************/
+
+#include <sstream>
+#include <string>
+
+#include "src/util/HashBatch.h"
+
+#include "test/Check.h"
+
+int main() {
+    const std::string a = write_file("manifest_a.cnf", "p cnf 2 2\n1 2 0\n-1 0\n");
+    const std::string b = write_file("manifest_b.cnf", "p cnf 2 1\n1 -2 0\n");
+    const std::string hash_a = gbd_hash_from_dimacs(a.c_str());
+    const std::string hash_b = gbd_hash_from_dimacs(b.c_str());
+    CHECK(hash_a.size() == 32 && hash_a != hash_b);
+
+    {  // all files verify, with CRLF line endings, comments and blank lines
+        std::istringstream manifest("# comment\r\n" + hash_a + " " + a + "\r\n\r\n" + hash_b + "\t" + b + "\r\n");
+        std::ostringstream out;
+        VerifyResult result = verify_manifest(manifest, 2, out);
+        CHECK(result.checked == 2);
+        CHECK(result.ok());
+        CHECK(out.str().empty());
+    }
+
+    {  // mismatch, missing file and malformed lines
+        std::istringstream manifest(hash_b + " " + a + "\n" + hash_a + " manifest_missing.cnf\n" + hash_a + "\n"
+            + hash_b + " \n" + hash_b + " " + b + "\n");
+        std::ostringstream out;
+        VerifyResult result = verify_manifest(manifest, 2, out);
+        CHECK(result.checked == 3);
+        CHECK(result.mismatched == 1);
+        CHECK(result.missing == 1);
+        CHECK(result.failed == 0);
+        CHECK(result.malformed == 2);
+        CHECK(!result.ok());
+        CHECK(out.str().find("MALFORMED 3: " + hash_a + "\n") != std::string::npos);
+        CHECK(out.str().find("MALFORMED 4: ") != std::string::npos);
+        CHECK(out.str().find("MISSING manifest_missing.cnf\n") != std::string::npos);
+        CHECK(out.str().find("MISMATCH " + hash_b + " " + hash_a + " " + a + "\n") != std::string::npos);
+    }
+
+    {  // a manifest with malformed lines only does not verify
+        std::istringstream manifest(hash_a + "\r\n");
+        std::ostringstream out;
+        CHECK(!verify_manifest(manifest, 1, out).ok());
+    }
+
+    return check_failures;
+}
@@ -0,0 +1,59 @@
+/*************************************************************************************************
+CNFTools -- Copyright (c) 2021, Markus Iser, KIT - Karlsruhe Institute of Technology
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT
+OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ **************************************************************************************************/
+
+#include <math.h>
+
+#include <cstdint>
+#include <vector>
+
+#include "src/features/PowerLaw.h"
+
+#include "test/Check.h"
+
+int main() {
+    {  // samples drawn exactly from x^-2.5 above x_min = 4, with a flat head below
+        std::vector<uint64_t> histogram(4, 1000);
+        for (unsigned x = 4; x < 100000; x++) histogram.push_back(static_cast<uint64_t>(round(1e7 * pow(x, -2.5))));
+        PowerLaw fit(histogram);
+        fit.analyze();
+        CHECK_NEAR(fit.alpha, 2.5, 0.05);
+        CHECK(fit.alpha_error > 0 && fit.alpha_error < 0.05);
+        CHECK(fit.x_min >= 4 && fit.x_min <= 8);
+        CHECK(fit.ks < 0.01);
+    }
+
+    {  // a single value has no tail, the likelihood is maximal on max_alpha
+        std::vector<uint64_t> histogram = { 0, 0, 0, 500 };
+        PowerLaw fit(histogram);
+        fit.analyze();
+        CHECK(isnan(fit.alpha));
+        CHECK(isnan(fit.alpha_error));
+        CHECK(fit.x_min == 3);
+    }
+
+    {  // no samples above zero, nothing is fitted
+        std::vector<uint64_t> histogram = { 10 };
+        PowerLaw fit(histogram);
+        fit.analyze();
+        CHECK(fit.alpha == 0);
+        CHECK(fit.n_tail == 0);
+    }
+
+    return check_failures;
+}
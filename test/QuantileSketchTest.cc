@@ -0,0 +1,77 @@
+/*************************************************************************************************
+CNFTools -- Copyright (c) 2021, Markus Iser, KIT - Karlsruhe Institute of Technology
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT
+OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ **************************************************************************************************/
+
+#include <math.h>
+
+#include <random>
+#include <vector>
+#include <algorithm>
+
+#include "src/util/Sketches.h"
+#include "src/features/Util.h"
+
+#include "test/Check.h"
+
+// Quantiles of floating point distributions do not depend on the partition of the samples into merged parts
+// (as with thread-local accumulators), are exact up to the exact limit and within the relative accuracy beyond
+int main() {
+    std::mt19937 rng(3);
+    std::uniform_int_distribution<unsigned> denominator(1, 40);
+    for (size_t n : { size_t(1000), QuantileSketch<float>::exact_limit, 5 * QuantileSketch<float>::exact_limit }) {
+        std::vector<float> samples(n);
+        for (float& x : samples) x = rng() % 5 == 0 ? 0 : 1.0f / denominator(rng);
+        std::vector<float> sorted(samples);
+        std::sort(sorted.begin(), sorted.end());
+
+        std::vector<float> reference;
+        for (unsigned parts : { 1, 3, 7 }) {
+            std::vector<Distribution<float>> local(parts);
+            for (size_t i = 0; i < n; i++) local[(i * 7919) % parts].add(samples[i]);
+            for (unsigned p = parts; p-- > 1; ) local[0].merge(local[p]);  // merge order differs from add order
+            std::vector<float> quantiles;
+            for (double q : { 0.0, 0.5, 0.9, 0.99, 1.0 }) {
+                const float expected = sorted[static_cast<size_t>(q * (n - 1) + 1e-9)];
+                const float actual = local[0].quantile(q);
+                if (n <= QuantileSketch<float>::exact_limit) {
+                    CHECK(actual == expected);
+                    CHECK(local[0].quantile_error(q) == 0);
+                } else {
+                    CHECK(fabs(actual - expected) <= QuantileSketch<float>::accuracy * expected + 1e-7);
+                    CHECK(fabs(actual - expected) <= local[0].quantile_error(q) + 1e-7);
+                }
+                quantiles.push_back(actual);
+            }
+            if (reference.empty()) reference = quantiles;
+            CHECK(quantiles == reference);
+        }
+    }
+
+    {  // negative values, zeros and NaN (ranked last) in the sketched range
+        QuantileSketch<double> sketch;
+        const size_t n = 2 * QuantileSketch<double>::exact_limit;
+        for (size_t i = 0; i < n; i++) sketch.add(i % 4 == 0 ? -2.0 : i % 4 == 1 ? 0.0 : i % 4 == 2 ? 3.0 : NAN);
+        CHECK(!sketch.exact());
+        CHECK_NEAR(sketch.quantile(0.1), -2, 2 * QuantileSketch<double>::accuracy);
+        CHECK(sketch.quantile(0.4) == 0);
+        CHECK_NEAR(sketch.quantile(0.6), 3, 3 * QuantileSketch<double>::accuracy);
+        CHECK(std::isnan(sketch.quantile(0.9)));
+    }
+
+    return check_failures;
+}
@@ -0,0 +1,52 @@
+/*************************************************************************************************
+CNFTools -- Copyright (c) 2021, Markus Iser, KIT - Karlsruhe Institute of Technology
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT
+OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ **************************************************************************************************/
+
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include "src/util/ResourceLimits.h"
+
+#include "test/Check.h"
+
+int main() {
+    ResourceLimits limits(1, 0);
+    CHECK(limits.get_runtime() < 0.5);
+
+    // four busy threads for 0.6 seconds of wallclock time (2.4 seconds of cpu time)
+    std::vector<std::thread> threads;
+    for (unsigned t = 0; t < 4; t++) {
+        threads.emplace_back([] () {
+            auto start = std::chrono::steady_clock::now();
+            volatile uint64_t spin = 0;
+            while (std::chrono::steady_clock::now() - start < std::chrono::milliseconds(600)) ++spin;
+        });
+    }
+    for (std::thread& thread : threads) thread.join();
+
+    CHECK(limits.get_runtime() >= 0.6);
+    CHECK(limits.get_runtime() < 1.0);
+    CHECK(limits.within_time_limit());
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(600));
+    CHECK(!limits.within_time_limit());
+    CHECK(ResourceLimits(0, 0).within_limits());
+
+    return check_failures;
+}
@@ -0,0 +1,92 @@
+/*************************************************************************************************
+CNFTools -- Copyright (c) 2021, Markus Iser, KIT - Karlsruhe Institute of Technology
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT
+OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ **************************************************************************************************/
+
+#include <math.h>
+
+#include <utility>
+#include <vector>
+
+#include "src/util/CSRGraph.h"
+#include "src/util/ResourceLimits.h"
+#include "src/features/Spectral.h"
+
+#include "test/Check.h"
+
+typedef std::vector<std::pair<unsigned, unsigned>> Edges;
+
+static CSRGraph graph(size_t n, const Edges& edges, const ResourceLimits& limits) {
+    std::vector<std::vector<unsigned>> neighbours(n);
+    for (auto edge : edges) {
+        neighbours[edge.first].push_back(edge.second);
+        neighbours[edge.second].push_back(edge.first);
+    }
+    return CSRGraph::build(n, 1, limits, [&] (unsigned, size_t v, std::vector<unsigned>* row) {
+        row->insert(row->end(), neighbours[v].begin(), neighbours[v].end());
+    });
+}
+
+int main() {
+    ResourceLimits limits(0, 0);
+
+    {  // path of n vertices: eigenvalues 2 cos(pi k / (n + 1)) of A, and cos(pi k / (n - 1)) of D^-1/2 A D^-1/2
+        const unsigned n = 50;
+        Edges edges;
+        for (unsigned v = 0; v + 1 < n; v++) edges.emplace_back(v, v + 1);
+        CSRGraph g = graph(n, edges, limits);
+        for (unsigned threads : { 1, 3 }) {
+            Spectral spectral(g, limits, threads);
+            spectral.analyze();
+            CHECK_NEAR(spectral.spectral_radius, 2 * cos(M_PI / (n + 1)), 1e-4);
+            CHECK_NEAR(spectral.lambda_2, cos(M_PI / (n - 1)), 1e-4);
+            CHECK(spectral.iterations > 0);
+        }
+    }
+
+    {  // cycle of n vertices: eigenvalues 2 cos(2 pi k / n) of A (and half of it for the normalized matrix)
+        const unsigned n = 40;
+        Edges edges;
+        for (unsigned v = 0; v < n; v++) edges.emplace_back(v, (v + 1) % n);
+        CSRGraph g = graph(n, edges, limits);
+        Spectral spectral(g, limits, 1);
+        spectral.analyze();
+        CHECK_NEAR(spectral.spectral_radius, 2, 1e-4);
+        CHECK_NEAR(spectral.lambda_2, cos(2 * M_PI / n), 1e-4);
+    }
+
+    {  // complete graph of n vertices: n - 1, and -1 / (n - 1) for the normalized matrix
+        const unsigned n = 12;
+        Edges edges;
+        for (unsigned u = 0; u < n; u++) for (unsigned v = u + 1; v < n; v++) edges.emplace_back(u, v);
+        CSRGraph g = graph(n, edges, limits);
+        Spectral spectral(g, limits, 1);
+        spectral.analyze();
+        CHECK_NEAR(spectral.spectral_radius, n - 1, 1e-4);
+        CHECK_NEAR(spectral.lambda_2, -1.0 / (n - 1), 1e-4);
+    }
+
+    {  // two disjoint triangles: the normalized matrix has the eigenvalue 1 twice
+        CSRGraph g = graph(6, { { 0, 1 }, { 1, 2 }, { 0, 2 }, { 3, 4 }, { 4, 5 }, { 3, 5 } }, limits);
+        Spectral spectral(g, limits, 1);
+        spectral.analyze();
+        CHECK_NEAR(spectral.spectral_radius, 2, 1e-4);
+        CHECK_NEAR(spectral.lambda_2, 1, 1e-4);
+    }
+
+    return check_failures;
+}
@@ -0,0 +1,108 @@
+/*************************************************************************************************
+CNFTools -- Copyright (c) 2021, Markus Iser, KIT - Karlsruhe Institute of Technology
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT
+OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ **************************************************************************************************/
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <new>
+#include <set>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "src/util/ThreadPool.h"
+
+#include "test/Check.h"
+
+int main() {
+    {  // blocks cover the range, and workers are reused across calls
+        std::set<std::thread::id> ids;
+        std::mutex mutex;
+        for (unsigned call = 0; call < 1000; call++) {
+            std::vector<unsigned> visited(1000, 0);
+            parallel_for(visited.size(), 4, [&] (unsigned t, size_t begin, size_t end) {
+                for (size_t i = begin; i < end; i++) visited[i] += 1 + t;
+                std::lock_guard<std::mutex> lock(mutex);
+                ids.insert(std::this_thread::get_id());
+            });
+            for (size_t i = 0; i < visited.size(); i++) CHECK(visited[i] == 1 + i * 4 / visited.size());
+        }
+        CHECK(ids.size() <= 4);
+    }
+
+    {  // an exception of a block is rethrown in the caller after all blocks have returned
+        std::atomic<unsigned> returned(0);
+        bool caught = false;
+        try {
+            parallel_for(8, 4, [&] (unsigned t, size_t, size_t) {
+                if (t == 2) throw std::bad_alloc();
+                std::this_thread::sleep_for(std::chrono::milliseconds(20));
+                ++returned;
+            });
+        } catch (std::bad_alloc&) {
+            caught = true;
+        }
+        CHECK(caught);
+        CHECK(returned == 3);
+    }
+
+    {  // limits exceeded in a chunk and exceptions of a chunk
+        ResourceLimits limits(0, 0);
+        bool caught = false;
+        try {
+            for_each_chunk(1000, 3, limits, [] (unsigned, size_t begin, size_t end) {
+                if (begin <= 500 && 500 < end) throw std::runtime_error("chunk");
+            }, 100);
+        } catch (std::runtime_error&) {
+            caught = true;
+        }
+        CHECK(caught);
+    }
+
+    {  // nested calls do not deadlock
+        std::atomic<unsigned> sum(0);
+        parallel_for(4, 4, [&] (unsigned, size_t begin, size_t end) {
+            for (size_t i = begin; i < end; i++) {
+                parallel_for(100, 4, [&] (unsigned, size_t b, size_t e) { sum += e - b; });
+            }
+        });
+        CHECK(sum == 400);
+    }
+
+    {  // the first exception of a pool task is rethrown by join(), remaining tasks are skipped
+        ThreadPool pool(2);
+        std::atomic<unsigned> done(0);
+        for (unsigned i = 0; i < 100; i++) {
+            pool.submit([&done, i] () {
+                if (i == 10) throw std::bad_alloc();
+                ++done;
+            });
+        }
+        bool caught = false;
+        try {
+            pool.join();
+        } catch (std::bad_alloc&) {
+            caught = true;
+        }
+        CHECK(caught);
+        CHECK(done < 50);
+    }
+
+    return check_failures;
+}
@@ -0,0 +1,92 @@
+/*************************************************************************************************
+CNFTools -- Copyright (c) 2021, Markus Iser, KIT - Karlsruhe Institute of Technology
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT
+OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ **************************************************************************************************/
+
+#include <utility>
+#include <vector>
+
+#include "src/util/CSRGraph.h"
+#include "src/util/ResourceLimits.h"
+#include "src/features/Treewidth.h"
+
+#include "test/Check.h"
+
+static CSRGraph graph(size_t n, const std::vector<std::pair<unsigned, unsigned>>& edges, const ResourceLimits& limits) {
+    std::vector<std::vector<unsigned>> neighbours(n);
+    for (auto edge : edges) {
+        neighbours[edge.first].push_back(edge.second);
+        neighbours[edge.second].push_back(edge.first);
+    }
+    return CSRGraph::build(n, 1, limits, [&] (unsigned, size_t v, std::vector<unsigned>* row) {
+        row->insert(row->end(), neighbours[v].begin(), neighbours[v].end());
+    });
+}
+
+static Treewidth analyze(const CSRGraph& graph, const ResourceLimits& limits, unsigned threads) {
+    Treewidth treewidth(graph, limits, threads);
+    treewidth.analyze();
+    return treewidth;
+}
+
+int main() {
+    ResourceLimits limits(0, 0);
+
+    {  // a path (with an isolated vertex) is a tree
+        std::vector<std::pair<unsigned, unsigned>> edges;
+        for (unsigned v = 1; v < 10; v++) edges.emplace_back(v, v + 1);
+        Treewidth tw = analyze(graph(11, edges, limits), limits, 1);
+        CHECK(tw.lower_bound == 1 && tw.min_degree == 1 && tw.min_fill == 1);
+    }
+
+    {  // cycles have treewidth two, cliques of size k have treewidth k - 1
+        std::vector<std::pair<unsigned, unsigned>> cycle, clique;
+        for (unsigned v = 0; v < 8; v++) cycle.emplace_back(v, (v + 1) % 8);
+        for (unsigned u = 0; u < 6; u++) for (unsigned v = u + 1; v < 6; v++) clique.emplace_back(u, v);
+        Treewidth cycle_tw = analyze(graph(8, cycle, limits), limits, 1);
+        CHECK(cycle_tw.lower_bound == 2 && cycle_tw.min_degree == 2 && cycle_tw.min_fill == 2);
+        Treewidth clique_tw = analyze(graph(6, clique, limits), limits, 1);
+        CHECK(clique_tw.lower_bound == 5 && clique_tw.min_degree == 5 && clique_tw.min_fill == 5);
+    }
+
+    {  // a k x k grid has treewidth k but degeneracy two, the bounds do not depend on the number of threads
+        const unsigned k = 6;
+        std::vector<std::pair<unsigned, unsigned>> edges;
+        for (unsigned r = 0; r < k; r++) for (unsigned c = 0; c < k; c++) {
+            if (c + 1 < k) edges.emplace_back(r * k + c, r * k + c + 1);
+            if (r + 1 < k) edges.emplace_back(r * k + c, (r + 1) * k + c);
+        }
+        CSRGraph grid = graph(k * k, edges, limits);
+        Treewidth tw = analyze(grid, limits, 1);
+        CHECK(tw.lower_bound == 2);
+        CHECK(tw.min_degree >= k && tw.min_fill >= k);
+        CHECK(tw.min_degree <= 2 * k && tw.min_fill <= 2 * k);
+        Treewidth parallel = analyze(grid, limits, 3);
+        CHECK(parallel.min_degree == tw.min_degree && parallel.min_fill == tw.min_fill);
+    }
+
+    {  // widths above max_width are reported as max_width + 1
+        const unsigned n = Treewidth::max_width + 10;
+        std::vector<std::pair<unsigned, unsigned>> edges;
+        for (unsigned u = 0; u < n; u++) for (unsigned v = u + 1; v < n; v++) edges.emplace_back(u, v);
+        Treewidth tw = analyze(graph(n, edges, limits), limits, 1);
+        CHECK(tw.lower_bound == Treewidth::max_width + 1);
+        CHECK(tw.min_degree == Treewidth::max_width + 1 && tw.min_fill == Treewidth::max_width + 1);
+    }
+
+    return check_failures;
+}
@@ -0,0 +1,107 @@
+/*************************************************************************************************
+CNFTools -- Copyright (c) 2021, Markus Iser, KIT - Karlsruhe Institute of Technology
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT
+OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ **************************************************************************************************/
+
+#include <chrono>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+#include <algorithm>
+
+#include "src/util/CNFFormula.h"
+#include "src/util/ResourceLimits.h"
+#include "src/util/WLFingerprint.h"
+
+#include "test/Check.h"
+
+typedef std::vector<std::vector<int>> Clauses;
+
+static CNFFormula formula(const Clauses& clauses) {
+    CNFFormula result;
+    for (const std::vector<int>& clause : clauses) {
+        Cl lits;
+        for (int lit : clause) lits.push_back(Lit(abs(lit), lit < 0));
+        result.readClause(lits.begin(), lits.end());
+    }
+    return result;
+}
+
+static std::string fingerprint(const Clauses& clauses, unsigned threads, unsigned* rounds = nullptr) {
+    CNFFormula cnf = formula(clauses);
+    ResourceLimits limits(0, 0);
+    WLFingerprint wl(cnf, limits, threads);
+    wl.analyze();
+    if (rounds != nullptr) *rounds = wl.rounds();
+    return wl.fingerprint();
+}
+
+int main() {
+    std::mt19937 rng(1);
+    const unsigned vars = 300;
+    Clauses clauses(1200);
+    for (std::vector<int>& clause : clauses) {
+        while (clause.size() < 3) {
+            int var = 1 + rng() % vars;
+            if (std::none_of(clause.begin(), clause.end(), [var] (int lit) { return abs(lit) == var; })) {
+                clause.push_back(rng() & 1 ? -var : var);
+            }
+        }
+    }
+
+    // renamed variables, flipped polarities of some variables, shuffled clauses and literals
+    std::vector<int> renaming(vars + 1);
+    for (unsigned v = 0; v <= vars; v++) renaming[v] = rng() & 1 ? -static_cast<int>(v) : v;
+    std::shuffle(renaming.begin() + 1, renaming.end(), rng);
+    Clauses renamed = clauses;
+    for (std::vector<int>& clause : renamed) {
+        for (int& lit : clause) lit = lit < 0 ? -renaming[-lit] : renaming[lit];
+        std::shuffle(clause.begin(), clause.end(), rng);
+    }
+    std::shuffle(renamed.begin(), renamed.end(), rng);
+
+    Clauses flipped = clauses;
+    flipped[42][0] = -flipped[42][0];
+
+    {  // isomorphic formulas get the same fingerprint, independent of the number of threads
+        unsigned rounds = 0;
+        const std::string expected = fingerprint(clauses, 1, &rounds);
+        CHECK(expected.size() == 32);
+        CHECK(rounds > 0);
+        CHECK(fingerprint(renamed, 1) == expected);
+        CHECK(fingerprint(renamed, 3) == expected);
+        CHECK(fingerprint(flipped, 1) != expected);
+    }
+
+    {  // limits are checked between rounds
+        CNFFormula cnf = formula(clauses);
+        ResourceLimits limits(1, 0);
+        std::this_thread::sleep_for(std::chrono::milliseconds(1100));
+        WLFingerprint wl(cnf, limits, 1);
+        bool exceeded = false;
+        try {
+            wl.analyze();
+        } catch (ResourceLimitsExceeded&) {
+            exceeded = true;
+        }
+        CHECK(exceeded);
+    }
+
+    return check_failures;
+}